@@ -57,6 +57,45 @@ inline void configuration::standard( Config & config ) {
         config.size_base                                   = 2;
         config.draw_initial_clustering                     = false;
         config.linewidth                                   = 0.5;
+        config.image_max_dim_px                            = 1200;
+        config.tiled_rasterizer                            = false;
+        config.additive_blending                           = false;
+        config.density_rendering                           = false;
+        config.density_of_nodes                            = false;
+        config.tone_mapping                                = TONE_MAPPING_LOG;
+        config.tile_pyramid                                = false;
+        config.tile_directory                              = "tiles";
+        config.tile_max_zoom                               = 5;
+        config.tile_coarse_zoom                            = 0;
+        config.stream_vector_output                        = false;
+        config.vector_precision                            = 2;
+        config.vector_quantization                         = 0;
+        config.edge_length_quantiles                       = 0;
+        config.png_compression_level                       = 6;
+        config.write_previews                              = false;
+        config.preview_prefix                              = "preview";
+        config.preview_coordinates                         = false;
+        config.preview_density                             = false;
+        config.write_hierarchy                             = false;
+        config.hierarchy_filename                          = "image.hierarchy";
+        config.quiet                                       = false;
+        config.sampled_stress_threshold                    = 50000;
+        config.stress_target_error                         = 0.02;
+        config.sampled_coordinate_scaling                  = false;
+        config.maxent_exact_threshold                      = 20000;
+        config.maxent_theta                                = 0.3;
+        config.report_filename                             = "";
+        config.draw_all_components                         = false;
+        config.use_input_partition                         = false;
+        config.input_partition_filename                    = "";
+        config.trace_filename                              = "";
+        config.perf_counters                               = false;
+        config.memory_report                               = false;
+        config.memory_budget                               = 0;
+        config.release_coarse_levels                       = false;
+        config.lean_contraction                            = false;
+        config.sampled_edge_length_colors                  = false;
+        config.metric_threads                              = 0;
         config.export_grafic_type                          = GRAPHICS_TYPE_PDF;
         config.intercluster_distance_factor                = 1;
         config.intracluster_distance_factor                = 1;
@@ -67,6 +106,9 @@ inline void configuration::standard( Config & config ) {
         config.image_scale                                 = 10.0;
         config.compute_FSM                                 = false;
         config.compute_MEnt                                = false;
+        config.compute_crossings                           = false;
+        config.crossing_samples                            = 0;
+        config.compute_neighborhood_preservation           = false;
         config.light_intercluster_edges                    = false;
         config.print_final_distances 		           = false;
         config.burn_image_to_disk                          = false;
@@ -80,7 +80,9 @@ int main(int argn, char **argv) {
         t.restart();
 
         burn_drawing bd;
-        bd.draw_graph(config, G);
+        if(!bd.draw_graph(config, G)) {
+                return 1;
+        }
 
         std::cout <<  "took " << t.elapsed()  << std::endl;
 
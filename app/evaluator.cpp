@@ -32,6 +32,7 @@
 #include "data_structure/graph_access.h"
 #include "graph_io.h"
 #include "tools/graph_extractor.h"
+#include "tools/layout_evaluator.h"
 #include "tools/quality_metrics.h"
 #include "macros_assertions.h"
 #include "parse_parameters.h"
@@ -72,26 +73,14 @@ int main(int argn, char **argv) {
                 qm.print_distances(G);
         }
 
-        double scaling_factor = qm.compute_fsm_scaling_factor_unit_weight(G);
-        std::cout <<  "scaling factor is " <<  scaling_factor << std::endl;
-        forall_nodes(G, node) {
-                G.setCoords(node, G.getX(node)*scaling_factor, G.getY(node)*scaling_factor);
-        } endfor
+        t.restart();
+        layout_evaluator evaluator;
+        evaluator.evaluate(config, G);
+        std::cout << "evaluation time: " << t.elapsed()  << std::endl;
 
-        forall_nodes(G, node) {
-                double rnd = random_functions::nextDouble(1e-7,1e-4);
-                double rnd2 = random_functions::nextDouble(1e-7,1e-4);
-                std::cout <<  "rnd " <<  rnd  << std::endl;
-                G.setCoords(node, G.getX(node)  + rnd , G.getY(node) + rnd2);
-        } endfor
-
-        
-        if(config.compute_FSM) {
-                std::cout <<  "FSM " << std::setprecision(200) << qm.full_stress_measure_unit_weight(G) << std::endl;
-        }
-
-        if(config.compute_MEnt) {
-                std::cout <<  "MEnt " << std::setprecision(200) << qm.maxent_unitweight(G, config.q, 0.008) << std::endl;
-                std::cout <<  "Avg. Invisibility per Edge "  << std::setprecision(200) << qm.avg_infeasibility_per_edge(G) << std::endl;
+        if(!config.report_filename.empty()) {
+                if(!evaluator.write_report(config.report_filename, graph_filename)) {
+                        return 1;
+                }
         }
 }
@@ -35,11 +35,15 @@
 #include "tools/quality_metrics.h"
 #include "macros_assertions.h"
 #include "parse_parameters.h"
+#include "drawing/component_drawer.h"
 #include "drawing/graph_drawer.h"
+#include "drawing/memory_planner.h"
 #include "drawing/config.h"
 #include "burn_drawing/burn_drawing.h"
 #include "random_functions.h"
+#include "memory_accounting.h"
 #include "timer.h"
+#include "trace_recorder.h"
 
 int main(int argn, char **argv) {
 
@@ -68,51 +72,89 @@ int main(int argn, char **argv) {
         }
 
         config.LogDump(stdout);
+        if(!config.trace_filename.empty() || config.perf_counters) {
+                trace_recorder::enable();
+        }
+        if(config.perf_counters) {
+                // before any worker thread exists, the counters are only inherited by threads created later
+                trace_recorder::enable_counters();
+        }
+        if(config.memory_report) {
+                memory_accounting::enable();
+                memory_accounting::record_phase("start");
+        }
+        if(config.memory_budget > 0) {
+                NodeID n = 0;
+                EdgeID m = 0;
+                if(graph_io::readGraphHeader(graph_filename, n, m)) {
+                        return 1;
+                }
+                memory_planner planner;
+                if(!planner.plan(config, n, m)) {
+                        return 1;
+                }
+        }
         graph_access G;     
 
         timer t;
-        graph_io::readGraphWeighted(G, graph_filename);
+        {
+                trace_scope scope("read graph");
+                graph_io::readGraphWeighted(G, graph_filename);
+        }
+        memory_accounting::record_graph("input graph", 0, G);
+        memory_accounting::record_phase("read graph");
+        if(config.use_input_partition) {
+                trace_scope scope("read partition");
+                if(graph_io::readPartition(G, config.input_partition_filename)) {
+                        return 1;
+                }
+        }
         std::cout << "io time: " << t.elapsed()  << std::endl;
        
 
-        if( G.number_of_nodes() < 100) {
-                config.faster_drawing_num_levels = 3;
-        } else if ( G.number_of_nodes() < 1000) {
-                config.faster_drawing_num_levels = 5;
-        } else if ( G.number_of_nodes() < 10000) {
-                config.faster_drawing_num_levels = 6;
-        } else if ( G.number_of_nodes() < 100000) {
-                config.faster_drawing_num_levels = 7;
-        } else if ( G.number_of_nodes() < 300000) {
-                config.faster_drawing_num_levels = 8;
-        } else if ( G.number_of_nodes() < 600000) {
-                config.faster_drawing_num_levels = 9;
-        } else if ( G.number_of_nodes() < 2000000) {
-                config.faster_drawing_num_levels = 10;
-        } else if ( G.number_of_nodes() < 4000000) {
-                config.faster_drawing_num_levels = 11;
-        } else if ( G.number_of_nodes() < 10000000) {
-                config.faster_drawing_num_levels = 12;
-        } else if ( G.number_of_nodes() < 20000000) {
-                config.faster_drawing_num_levels = 15;
-        } else if ( G.number_of_nodes() < 40000000) {
-                config.faster_drawing_num_levels = 17;
-        } else {
-                config.faster_drawing_num_levels = 20;
-        }
+        config.faster_drawing_num_levels = graph_drawer::faster_drawing_levels(G.number_of_nodes());
 
         srand(config.seed);
         random_functions::setSeed(config.seed);
 
-        graph_access Q;
-        graph_extractor E;
-        E.extract_largest_component(G, Q);
-
         // **************************** compute coordinates *****************************************       
-        graph_drawer gd;
-        std::cout <<  "performing drawing!"  << std::endl;
-        config.upper_bound_partition = Q.number_of_nodes()-1;
-        gd.perform_drawing(config, Q);
+        graph_access largest_component;
+        graph_access & Q = config.draw_all_components ? G : largest_component;
+        if(config.draw_all_components) {
+                trace_scope scope("draw all components");
+                component_drawer cd;
+                cd.draw_all_components(config, G);
+                memory_accounting::record_phase("draw all components");
+        } else {
+                std::vector< PartitionID > input_partition;
+                if(config.use_input_partition) {
+                        input_partition.resize(G.number_of_nodes());
+                        forall_nodes(G, node) {
+                                input_partition[node] = G.getPartitionIndex(node);
+                        } endfor
+                }
+
+                std::vector< NodeID > mapping;
+                graph_extractor E;
+                {
+                        trace_scope scope("extract largest component");
+                        E.extract_largest_component(G, Q, mapping);
+                }
+                memory_accounting::record_phase("extract largest component");
+
+                if(config.use_input_partition) {
+                        forall_nodes(Q, node) {
+                                Q.setPartitionIndex(node, input_partition[mapping[node]]);
+                        } endfor
+                }
+
+                graph_drawer gd;
+                std::cout <<  "performing drawing!"  << std::endl;
+                config.upper_bound_partition = Q.number_of_nodes()-1;
+                trace_scope scope("drawing", Q.number_of_nodes());
+                gd.perform_drawing(config, Q);
+                memory_accounting::record_phase("drawing");
+        }
         
         // ******************************* done ''drawing'' *****************************************       
         ofs.close();
@@ -120,8 +162,13 @@ int main(int argn, char **argv) {
         std::cout <<  "time spent " << t.elapsed()  << std::endl;
 
         
+        // a failed output is reported in the exit status, the remaining outputs are still written
+        int exit_code = 0;
+
         quality_metrics qm;
+        qm.set_num_threads(config.metric_threads);
         if(config.burn_image_to_disk) {
+                trace_scope scope("render");
                 std::cout <<  "now performing sparse scaling " <<  std::endl;
                 double scaling_factor = qm.compute_sparse_scaling_factor_unit_weight(Q);
                 std::cout <<  "sparse scaling factor is " <<  scaling_factor << std::endl;
@@ -135,32 +182,86 @@ int main(int argn, char **argv) {
                 t.restart();
 
                 burn_drawing bd;
-                bd.draw_graph(config, Q);
+                if(!bd.draw_graph(config, Q)) {
+                        exit_code = 1;
+                }
 
                 std::cout <<  "took " << t.elapsed()  << std::endl;
         }
 
+        // the scaling factor and the FSM come from one BFS pass, the FSM is taken at the optimal scaling factor 
+        // and does not change when the coordinates are scaled. written coordinates are scaled exactly unless 
+        // sampled scaling is asked for, then the exact sums also give the exact FSM.
+        bool sample_stress = Q.number_of_nodes() > config.sampled_stress_threshold;
+        if( config.burn_coordinates_to_disk && !config.sampled_coordinate_scaling ) {
+                sample_stress = false;
+        }
+
         if(config.compute_FSM || config.compute_MEnt || config.burn_coordinates_to_disk) {
+                trace_scope scope("scaling factor");
                 std::cout <<  "now strong computing scaling factor and scaling"  << std::endl;
-                double scaling_factor = qm.compute_fsm_scaling_factor_unit_weight(Q);
+                double scaling_factor = 1;
+                double fsm            = 0;
+                stress_estimate estimate;
+                if( sample_stress ) {
+                        estimate       = qm.sampled_stress_measure_unit_weight(Q, config.stress_target_error);
+                        scaling_factor = estimate.scaling_factor;
+                        fsm            = estimate.stress;
+                        std::cout <<  "scaling factor estimated from " <<  estimate.num_sources << " sources" << std::endl;
+                } else {
+                        // sum (s*d - D)^2/D^2 = s^2 * bottom - 2s * top + pairs, which is
+                        // pairs - top^2/bottom for the optimal scaling factor s = top/bottom
+                        double top_fraction, bottom_fraction, num_pairs;
+                        qm.full_stress_sums_unit_weight(Q, top_fraction, bottom_fraction, num_pairs);
+                        if( bottom_fraction > 0 ) {
+                                scaling_factor = top_fraction/bottom_fraction;
+                        }
+                        fsm = (num_pairs - top_fraction*scaling_factor)/2;
+                }
                 std::cout <<  "scaling factor is " <<  scaling_factor << std::endl;
 
                 //scale coordinates
                 forall_nodes(Q, node) {
                         Q.setCoords(node, Q.getX(node)*scaling_factor, Q.getY(node)*scaling_factor);
                 } endfor
-        }
 
-        if(config.compute_FSM) {
-                std::cout <<  "FSM " << std::setprecision(200) << qm.full_stress_measure_unit_weight(Q) << std::endl;
+                if(config.compute_FSM) {
+                        std::cout <<  "FSM " << std::setprecision(200) << fsm << std::endl;
+                        if( sample_stress ) {
+                                std::cout <<  "FSM 95% confidence interval +- " << std::setprecision(6) << estimate.confidence 
+                                          <<  " (" << estimate.num_sources << " of " << Q.number_of_nodes() << " sources)" << std::endl;
+                        }
+                }
         }
 
         if(config.compute_MEnt) {
-                std::cout <<  "MEnt " << std::setprecision(200) << qm.maxent_unitweight(Q, config.q, 0.008) << std::endl;
+                trace_scope scope("MEnt");
+                if( Q.number_of_nodes() > config.maxent_exact_threshold ) {
+                        double error_bound = 0;
+                        double ment = qm.maxent_unitweight_approximate(Q, config.q, 0.008, config.maxent_theta, error_bound);
+                        std::cout <<  "MEnt " << std::setprecision(200) << ment << std::endl;
+                        std::cout <<  "MEnt error bound +- " << std::setprecision(6) << error_bound << std::endl;
+                } else {
+                        std::cout <<  "MEnt " << std::setprecision(200) << qm.maxent_unitweight(Q, config.q, 0.008) << std::endl;
+                }
                 std::cout <<  "Avg. Invisibility per Edge "  << std::setprecision(200) << qm.avg_infeasibility_per_edge(Q) << std::endl;
         }
         
         if(config.burn_coordinates_to_disk) {
+                trace_scope scope("write coordinates");
                 graph_io::writeCoordinates(Q, config.output_coord_filename);
         }
+
+        if(!config.trace_filename.empty()) {
+                trace_recorder::write(config.trace_filename);
+        }
+        if(config.perf_counters) {
+                trace_recorder::print_summary();
+                perf_counters::close();
+        }
+        if(config.memory_report) {
+                memory_accounting::record_phase("end");
+                memory_accounting::print_report(G.number_of_nodes(), G.number_of_edges()/2);
+        }
+        return exit_code;
 }
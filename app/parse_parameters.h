@@ -25,6 +25,7 @@
 
 #include <omp.h>
 #include "configuration.h"
+#include "burn_drawing/tile_pyramid.h"
 
 int parse_parameters(int argn, char **argv, 
                      Config & config, 
@@ -61,18 +62,54 @@ int parse_parameters(int argn, char **argv,
         struct arg_dbl *general_distance_scaling_factor      = arg_dbl0(NULL, "general_distance_scaling_factor", NULL, "General factor for distance scaling.");
 
         //struct arg_lit *disable_scaling                      = arg_lit0(NULL, "disable_scaling","Disable scaling.");
-        struct arg_lit *draw_cluster_first                   = arg_lit0(NULL, "draw_cluster_first","Draw each cluster first while keeping the others unpacked.");
+        struct arg_lit *draw_cluster_first                   = arg_lit0(NULL, "draw_cluster_first","Draw each cluster of the first clustering on its own in parallel and place the clusters with the coarser levels.");
         struct arg_int *num_threads                          = arg_int0(NULL, "num_threads", NULL, "Set the number of OMP threads.");
-        struct arg_lit *draw_cluster_first_disable_fine_tune = arg_lit0(NULL, "draw_cluster_first_disable_fine_tune","Disable the n^2 step when drawing clustering first.");
+        struct arg_lit *draw_cluster_first_disable_fine_tune = arg_lit0(NULL, "draw_cluster_first_disable_fine_tune","Disable the final optimization of the whole graph when drawing clusters first.");
         struct arg_lit *compute_FSM                          = arg_lit0(NULL, "compute_FSM","Enable computation of Full Stress Measure.");
         struct arg_lit *compute_MEnt                         = arg_lit0(NULL, "compute_MEnt","Enable computation of MaxEnt-stress.");
+        struct arg_lit *compute_crossings                    = arg_lit0(NULL, "compute_crossings","Enable counting of edge crossings.");
+        struct arg_int *crossing_samples                     = arg_int0(NULL, "crossing_samples", NULL, "Estimate the edge crossings from this many random edges (default 0 = exact).");
+        struct arg_lit *compute_neighborhood_preservation    = arg_lit0(NULL, "compute_neighborhood_preservation","Enable comparison of graph neighborhoods with nearest neighbors in the drawing.");
         struct arg_lit *print_final_distances                = arg_lit0(NULL, "print_final_distances","Print the final distances.");
         struct arg_lit *light_intercluster_edges             = arg_lit0(NULL, "light_intercluster_edges","Enable draw intercluster edges in light gray.");
         struct arg_dbl *image_scale                          = arg_dbl0(NULL, "image_scale", NULL, "Set image scale.");
         struct arg_dbl *linewidth                            = arg_dbl0(NULL, "linewidth", NULL, "Line width to use for drawing.");
+        struct arg_int *image_size                           = arg_int0(NULL, "image_size", NULL, "Size of the larger side of png images in pixels (default 1200).");
+        struct arg_lit *tiled_rasterizer                     = arg_lit0(NULL, "tiled_rasterizer","Render png images with the built-in multi-threaded tiled rasterizer.");
+        struct arg_lit *additive_blending                    = arg_lit0(NULL, "additive_blending","Accumulate overlapping edges when using the tiled rasterizer.");
+        struct arg_lit *density_rendering                    = arg_lit0(NULL, "density_rendering","Render a density image of the edges instead of drawing every edge (png only).");
+        struct arg_lit *density_nodes                        = arg_lit0(NULL, "density_nodes","Use the node density instead of the edge coverage for density rendering.");
+        struct arg_rex *tone_mapping                         = arg_rex0(NULL, "tone_mapping","^(log|histogram)$","TYPE", REG_EXTENDED, "Tone mapping of density images. (Default: log) [log|histogram]");
+        struct arg_lit *tile_pyramid                         = arg_lit0(NULL, "tile_pyramid","Write an XYZ pyramid of png tiles instead of a single image.");
+        struct arg_str *tile_directory                       = arg_str0(NULL, "tile_directory", NULL, "Output directory of the tile pyramid (default tiles).");
+        struct arg_int *tile_max_zoom                        = arg_int0(NULL, "tile_max_zoom", NULL, "Deepest zoom level of the tile pyramid, at most 22 (default 5).");
+        struct arg_int *tile_coarse_zoom                     = arg_int0(NULL, "tile_coarse_zoom", NULL, "Zoom levels below this one draw the quotient graph of the clustering (default 0).");
+        struct arg_lit *stream_vector_output                 = arg_lit0(NULL, "stream_vector_output","Write pdf files with the streaming writer instead of cairo (svg files are always streamed).");
+        struct arg_int *vector_precision                     = arg_int0(NULL, "vector_precision", NULL, "Number of decimal places of coordinates in streamed pdf/svg files (default 2).");
+        struct arg_dbl *vector_quantization                  = arg_dbl0(NULL, "vector_quantization", NULL, "Round coordinates in streamed pdf/svg files to multiples of this value (default 0 = off).");
+        struct arg_int *color_quantiles                      = arg_int0(NULL, "color_quantiles", NULL, "Color edges by length on a ramp of this many quantiles (default 0 = short/medium/long by median).");
+        struct arg_int *png_compression_level                = arg_int0(NULL, "png_compression_level", NULL, "Compression level of png files from 0 (store) over 1 (fastest) to 9 (default 6).");
+        struct arg_lit *write_previews                       = arg_lit0(NULL, "write_previews","Write a preview png of every level during uncoarsening.");
+        struct arg_str *preview_prefix                       = arg_str0(NULL, "preview_prefix", NULL, "Prefix of the preview files, level i is written to <prefix>_level<i>.png (default preview).");
+        struct arg_lit *preview_coordinates                  = arg_lit0(NULL, "preview_coordinates","Also write the coordinates of every level during uncoarsening.");
+        struct arg_lit *preview_density                      = arg_lit0(NULL, "preview_density","Use density images as previews.");
+        struct arg_lit *write_hierarchy                      = arg_lit0(NULL, "write_hierarchy","Write all levels of the multilevel hierarchy to a binary file.");
+        struct arg_str *hierarchy_filename                   = arg_str0(NULL, "hierarchy_filename", NULL, "Output filename of the hierarchy file (default image.hierarchy).");
+        struct arg_int *sampled_stress_threshold             = arg_int0(NULL, "sampled_stress_threshold", NULL, "Estimate the FSM from sampled BFS sources on graphs with more nodes (default 50000).");
+        struct arg_dbl *stress_target_error                  = arg_dbl0(NULL, "stress_target_error", NULL, "Relative half width of the 95% confidence interval of sampled FSM estimates (default 0.02).");
+        struct arg_lit *sampled_coordinate_scaling           = arg_lit0(NULL, "sampled_coordinate_scaling","Scale the written coordinates with the sampled scaling factor on graphs above sampled_stress_threshold instead of the exact one.");
+        struct arg_int *maxent_exact_threshold               = arg_int0(NULL, "maxent_exact_threshold", NULL, "Approximate the MaxEnt-stress entropy term with a kd-tree on graphs with more nodes (default 20000).");
+        struct arg_dbl *maxent_theta                         = arg_dbl0(NULL, "maxent_theta", NULL, "Opening angle of the approximate MaxEnt-stress evaluation (default 0.3).");
+        struct arg_str *report_filename                      = arg_str0(NULL, "report_filename", NULL, "Write the computed metrics to this file (CSV if it ends with .csv, JSON otherwise).");
+        struct arg_lit *draw_all_components                  = arg_lit0(NULL, "draw_all_components","Draw all connected components and pack them into one drawing instead of only the largest one.");
+        struct arg_str *input_partition                      = arg_str0(NULL, "input_partition", NULL, "Use the clustering in this partition file as first coarsening level.");
+        struct arg_str *trace_filename                       = arg_str0(NULL, "trace_filename", NULL, "Write the timings of all phases and levels to this file (Chrome trace event format).");
+        struct arg_lit *perf_counters                        = arg_lit0(NULL, "perf_counters", "Count cycles, instructions, LLC misses and branch misses of all phases and levels and print a summary (Linux, falls back to timings if the counters are not available).");
+        struct arg_lit *memory_report                        = arg_lit0(NULL, "memory_report", "Print the memory used per level and structure, the resident set size per phase and a model of the footprint in the number of nodes and edges.");
+        struct arg_dbl *memory_budget                        = arg_dbl0(NULL, "memory_budget", NULL, "Memory budget in MB. Chooses algorithms whose estimated peak memory fits and stops with an estimate if none does. Default: no limit.");
         struct arg_dbl *q                                    = arg_dbl0(NULL, "q", NULL, "Parameter q in the MaxEnt formular.");
         struct arg_int *label_propagation_iterations         = arg_int0(NULL, "label_propagation_iterations", NULL, "Number of LP iterations.");
-        struct arg_rex *export_type                          = arg_rex0(NULL, "export_type","^(pdf|png)$","TYPE", REG_EXTENDED, "Specify export type. [pdf|png]");
+        struct arg_rex *export_type                          = arg_rex0(NULL, "export_type","^(pdf|png|svg)$","TYPE", REG_EXTENDED, "Specify export type. [pdf|png|svg]");
         struct arg_rex *preconfiguration                     = arg_rex0(NULL, "preconfiguration", "^(strong|eco|fast)$", "VARIANT", REG_EXTENDED, "Use a preconfiguration. (Default: fast) [strong|eco|fast]." );
 
 
@@ -110,9 +147,43 @@ int parse_parameters(int argn, char **argv,
                 num_threads,
                 export_type,
                 linewidth,
+                image_size,
+                tiled_rasterizer,
+                additive_blending,
+                density_rendering,
+                density_nodes,
+                tone_mapping,
+                tile_pyramid,
+                tile_directory,
+                tile_max_zoom,
+                tile_coarse_zoom,
+                stream_vector_output,
+                vector_precision,
+                vector_quantization,
+                color_quantiles,
+                png_compression_level,
                 //print_final_distances,
                 compute_FSM,
                 compute_MEnt,
+                write_previews,
+                preview_prefix,
+                preview_coordinates,
+                preview_density,
+                write_hierarchy,
+                hierarchy_filename,
+                sampled_stress_threshold,
+                stress_target_error,
+                sampled_coordinate_scaling,
+                maxent_exact_threshold,
+                maxent_theta,
+                draw_all_components,
+                draw_cluster_first,
+                draw_cluster_first_disable_fine_tune,
+                input_partition,
+                trace_filename,
+                perf_counters,
+                memory_report,
+                memory_budget,
                 //disable_scaling,
 #endif
 #endif
@@ -120,12 +191,36 @@ int parse_parameters(int argn, char **argv,
                 print_final_distances,
                 compute_FSM,
                 compute_MEnt,
+                compute_crossings,
+                crossing_samples,
+                compute_neighborhood_preservation,
                 coord_filename,
+                sampled_stress_threshold,
+                stress_target_error,
+                maxent_exact_threshold,
+                maxent_theta,
+                report_filename,
 #endif
 #ifdef MODE_DRAWFROMCOORDS
                 output_filename, 
                 coord_filename,
                 export_type,
+                linewidth,
+                image_size,
+                tiled_rasterizer,
+                additive_blending,
+                density_rendering,
+                density_nodes,
+                tone_mapping,
+                tile_pyramid,
+                tile_directory,
+                tile_max_zoom,
+                tile_coarse_zoom,
+                stream_vector_output,
+                vector_precision,
+                vector_quantization,
+                color_quantiles,
+                png_compression_level,
 #endif
 #endif
 
@@ -191,6 +286,11 @@ int parse_parameters(int argn, char **argv,
                         }
                 } else if (strcmp("pdf", export_type->sval[0]) == 0) {
                         config.export_grafic_type = GRAPHICS_TYPE_PDF;
+                } else if (strcmp("svg", export_type->sval[0]) == 0) {
+                        config.export_grafic_type = GRAPHICS_TYPE_SVG;
+                        if(!config.output_filename.compare("image.pdf")) {
+                                config.output_filename = std::string("image.svg");
+                        }
                 } else {
                         fprintf(stderr, "Invalid export type variant: \"%s\"\n", export_type->sval[0]);
                         exit(0);
@@ -228,6 +328,18 @@ int parse_parameters(int argn, char **argv,
                 config.compute_MEnt = true;
         }
 
+        if(compute_crossings->count > 0)  {
+                config.compute_crossings = true;
+        }
+
+        if(crossing_samples->count > 0)  {
+                config.crossing_samples = crossing_samples->ival[0];
+        }
+
+        if(compute_neighborhood_preservation->count > 0)  {
+                config.compute_neighborhood_preservation = true;
+        }
+
         if(light_intercluster_edges->count > 0)  {
                 config.light_intercluster_edges = true;
         }
@@ -292,6 +404,129 @@ int parse_parameters(int argn, char **argv,
                 config.linewidth = linewidth->dval[0];
         }
 
+        if(image_size->count > 0)  {
+                if(image_size->ival[0] < 1) {
+                        fprintf(stderr, "Invalid image size: %d, it has to be at least 1\n", image_size->ival[0]);
+                        exit(1);
+                }
+                config.image_max_dim_px = image_size->ival[0];
+        }
+
+        if(tiled_rasterizer->count > 0)  {
+                config.tiled_rasterizer = true;
+        }
+
+        if(additive_blending->count > 0)  {
+                config.additive_blending = true;
+        }
+
+        if(density_rendering->count > 0)  {
+                config.density_rendering = true;
+        }
+
+        if(density_nodes->count > 0)  {
+                config.density_of_nodes = true;
+        }
+
+        if(tone_mapping->count > 0) {
+                if (strcmp("log", tone_mapping->sval[0]) == 0) {
+                        config.tone_mapping = TONE_MAPPING_LOG;
+                } else if (strcmp("histogram", tone_mapping->sval[0]) == 0) {
+                        config.tone_mapping = TONE_MAPPING_HISTOGRAM;
+                } else {
+                        fprintf(stderr, "Invalid tone mapping variant: \"%s\"\n", tone_mapping->sval[0]);
+                        exit(0);
+                }
+        }
+
+        if(tile_pyramid->count > 0)  {
+                config.tile_pyramid = true;
+        }
+
+        if(tile_directory->count > 0)  {
+                config.tile_directory = tile_directory->sval[0];
+        }
+
+        if(tile_max_zoom->count > 0)  {
+                if(tile_max_zoom->ival[0] < 0 || tile_max_zoom->ival[0] > MAX_TILE_ZOOM) {
+                        fprintf(stderr, "Invalid tile max zoom: %d, it has to be between 0 and %d\n", tile_max_zoom->ival[0], MAX_TILE_ZOOM);
+                        exit(1);
+                }
+                config.tile_max_zoom = tile_max_zoom->ival[0];
+        }
+
+        if(tile_coarse_zoom->count > 0)  {
+                config.tile_coarse_zoom = tile_coarse_zoom->ival[0];
+        }
+
+        if(stream_vector_output->count > 0)  {
+                config.stream_vector_output = true;
+        }
+
+        if(vector_precision->count > 0)  {
+                config.vector_precision = vector_precision->ival[0];
+        }
+
+        if(vector_quantization->count > 0)  {
+                config.vector_quantization = vector_quantization->dval[0];
+        }
+
+        if(color_quantiles->count > 0)  {
+                config.edge_length_quantiles = color_quantiles->ival[0];
+        }
+
+        if(png_compression_level->count > 0)  {
+                config.png_compression_level = png_compression_level->ival[0];
+        }
+
+        if(write_previews->count > 0)  {
+                config.write_previews = true;
+        }
+
+        if(preview_prefix->count > 0)  {
+                config.preview_prefix = preview_prefix->sval[0];
+        }
+
+        if(preview_coordinates->count > 0)  {
+                config.preview_coordinates = true;
+        }
+
+        if(preview_density->count > 0)  {
+                config.preview_density = true;
+        }
+
+        if(write_hierarchy->count > 0)  {
+                config.write_hierarchy = true;
+        }
+
+        if(hierarchy_filename->count > 0)  {
+                config.hierarchy_filename = hierarchy_filename->sval[0];
+        }
+
+        if(sampled_stress_threshold->count > 0)  {
+                config.sampled_stress_threshold = sampled_stress_threshold->ival[0];
+        }
+
+        if(stress_target_error->count > 0)  {
+                config.stress_target_error = stress_target_error->dval[0];
+        }
+
+        if(sampled_coordinate_scaling->count > 0)  {
+                config.sampled_coordinate_scaling = true;
+        }
+
+        if(maxent_exact_threshold->count > 0)  {
+                config.maxent_exact_threshold = maxent_exact_threshold->ival[0];
+        }
+
+        if(maxent_theta->count > 0)  {
+                config.maxent_theta = maxent_theta->dval[0];
+        }
+
+        if(report_filename->count > 0)  {
+                config.report_filename = report_filename->sval[0];
+        }
+
         if(lp_factor->count > 0)  {
                 config.cluster_coarsening_factor = lp_factor->dval[0];
         }
@@ -312,6 +547,31 @@ int parse_parameters(int argn, char **argv,
                 config.general_distance_scaling_factor = general_distance_scaling_factor->dval[0];
         }
 
+        if(draw_all_components->count > 0)  {
+                config.draw_all_components = true;
+        }
+
+        if(input_partition->count > 0)  {
+                config.use_input_partition      = true;
+                config.input_partition_filename = input_partition->sval[0];
+        }
+
+        if(trace_filename->count > 0)  {
+                config.trace_filename = trace_filename->sval[0];
+        }
+
+        if(perf_counters->count > 0)  {
+                config.perf_counters = true;
+        }
+
+        if(memory_report->count > 0)  {
+                config.memory_report = true;
+        }
+
+        if(memory_budget->count > 0)  {
+                config.memory_budget = memory_budget->dval[0];
+        }
+
         if(num_threads->count > 0)  {
                 omp_set_num_threads(num_threads->ival[0]);
         }
@@ -20,9 +20,17 @@
  *****************************************************************************/
 
 
+#include <omp.h>
+
 #include "shortest_paths.h"
 #include "data_structure/priority_queues/minNodeHeap.h"
 
+// switching thresholds of the direction optimizing BFS (alpha and beta of Beamer et al.)
+const EdgeID BFS_TOP_DOWN_EDGE_FACTOR   = 14;
+const NodeID BFS_BOTTOM_UP_NODE_FACTOR  = 24;
+// frontiers below this size are expanded by a single thread
+const NodeID BFS_PARALLEL_FRONTIER_SIZE = 1024;
+
 shortest_paths::shortest_paths() {
                 
 }
@@ -31,34 +39,136 @@ shortest_paths::~shortest_paths() {
                 
 }
 
-void shortest_paths::one_to_many_unit_weight( graph_access & G, NodeID & source, std::vector< int > & distances) {
-        // perform a BFS to compute the distance from source to all other vertices
-        distances.resize( G.number_of_nodes() ); 
-        std::queue< NodeID > bfsqueue;
+void shortest_paths::bfs_order( graph_access & G, std::vector< NodeID > & order ) {
+        order.clear();
+        order.reserve(G.number_of_nodes());
 
-        forall_nodes(G, node) {
-                distances[node] = -1;
+        std::vector< int > distances(G.number_of_nodes(), -1);
+        EdgeID unexplored_edges = G.number_of_edges();
+        forall_nodes(G, start) {
+                if( distances[start] != -1 ) continue;
+                direction_optimizing_bfs( G, start, distances, order, unexplored_edges );
         } endfor
+}
+
+void shortest_paths::direction_optimizing_bfs( graph_access & G, NodeID source, std::vector< int > & distances, 
+                                               std::vector< NodeID > & order, EdgeID & unexplored_edges ) {
+        std::vector< uint64_t > frontier_bitmap;
 
         distances[source] = 0;
-        int cur_deepth    = 0;
+        order.push_back(source);
+
+        NodeID frontier_begin = order.size() - 1;
+        EdgeID frontier_edges = G.getNodeDegree(source);
+        unexplored_edges     -= frontier_edges;
+
+        bool bottom_up = false;
+        int deepth     = 0;
+        while( frontier_begin < order.size() ) {
+                NodeID frontier_end  = order.size();
+                NodeID frontier_size = frontier_end - frontier_begin;
+                deepth++;
+
+                // bottom-up pays off once the frontier has more edges than the unvisited part of the graph,
+                // but it scans all nodes, so the frontier must not be small compared to the graph either
+                bool large_frontier = frontier_size >= G.number_of_nodes() / BFS_BOTTOM_UP_NODE_FACTOR;
+                if( !bottom_up && large_frontier && frontier_edges > unexplored_edges / BFS_TOP_DOWN_EDGE_FACTOR ) {
+                        bottom_up = true;
+                } else if( bottom_up && !large_frontier ) {
+                        bottom_up = false;
+                }
+
+                if( bottom_up ) {
+                        frontier_edges = bottom_up_step( G, deepth, distances, order, frontier_begin, frontier_end, frontier_bitmap );
+                } else {
+                        frontier_edges = top_down_step( G, deepth, distances, order, frontier_begin, frontier_end );
+                }
+                unexplored_edges -= frontier_edges;
+                frontier_begin    = frontier_end;
+        }
+}
+
+EdgeID shortest_paths::top_down_step( graph_access & G, int deepth, std::vector< int > & distances, std::vector< NodeID > & order, 
+                                      NodeID frontier_begin, NodeID frontier_end ) {
+        EdgeID next_frontier_edges = 0;
 
-        bfsqueue.push(source);
-        while(!bfsqueue.empty()) {
-                NodeID node = bfsqueue.front();
-                bfsqueue.pop(); 
+        // small frontiers are not worth starting threads
+        int num_threads = omp_get_max_threads();
+        if( num_threads == 1 || frontier_end - frontier_begin < BFS_PARALLEL_FRONTIER_SIZE ) {
+                for( NodeID f = frontier_begin; f < frontier_end; f++) {
+                        NodeID node = order[f];
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if( distances[target] == -1 ) {
+                                        distances[target] = deepth;
+                                        order.push_back(target);
+                                        next_frontier_edges += G.getNodeDegree(target);
+                                }
+                        } endfor
+                }
+                return next_frontier_edges;
+        }
 
-                if (distances[node] == cur_deepth) {
-                        cur_deepth++;
+        std::vector< std::vector< NodeID > > next_frontier(num_threads);
+        #pragma omp parallel reduction(+:next_frontier_edges)
+        {
+                std::vector< NodeID > & local_frontier = next_frontier[omp_get_thread_num()];
+
+                #pragma omp for schedule(dynamic, 256)
+                for( NodeID f = frontier_begin; f < frontier_end; f++) {
+                        NodeID node = order[f];
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if( distances[target] == -1 && __sync_bool_compare_and_swap(&distances[target], -1, deepth) ) {
+                                        local_frontier.push_back(target);
+                                        next_frontier_edges += G.getNodeDegree(target);
+                                }
+                        } endfor
                 }
+        }
 
-                forall_out_edges(G, e, node) {
-                        NodeID target = G.getEdgeTarget(e);
-                        if(distances[target] == -1) {
-                                distances[target] = cur_deepth;        
-                                bfsqueue.push(target);
-                        }
-                } endfor
+        for( int thread = 0; thread < num_threads; thread++) {
+                order.insert(order.end(), next_frontier[thread].begin(), next_frontier[thread].end());
         }
+        return next_frontier_edges;
+}
+
+EdgeID shortest_paths::bottom_up_step( graph_access & G, int deepth, std::vector< int > & distances, std::vector< NodeID > & order, 
+                                       NodeID frontier_begin, NodeID frontier_end, std::vector< uint64_t > & frontier_bitmap ) {
+        int num_threads = omp_get_max_threads();
+        std::vector< std::vector< NodeID > > next_frontier(num_threads);
+        EdgeID next_frontier_edges = 0;
 
+        frontier_bitmap.assign(G.number_of_nodes() / 64 + 1, 0);
+        #pragma omp parallel reduction(+:next_frontier_edges)
+        {
+                #pragma omp for schedule(static)
+                for( NodeID f = frontier_begin; f < frontier_end; f++) {
+                        NodeID node = order[f];
+                        __sync_fetch_and_or(&frontier_bitmap[node / 64], (uint64_t)1 << (node % 64));
+                }
+
+                // static scheduling hands out consecutive ranges in thread order, so the 
+                // new frontier ends up sorted by node id
+                std::vector< NodeID > & local_frontier = next_frontier[omp_get_thread_num()];
+                #pragma omp for schedule(static)
+                for( NodeID node = 0; node < G.number_of_nodes(); node++) {
+                        if( distances[node] != -1 ) continue;
+
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                if( frontier_bitmap[target / 64] & ((uint64_t)1 << (target % 64)) ) {
+                                        distances[node] = deepth;
+                                        local_frontier.push_back(node);
+                                        next_frontier_edges += G.getNodeDegree(node);
+                                        break;
+                                }
+                        } endfor
+                }
+        }
+
+        for( int thread = 0; thread < num_threads; thread++) {
+                order.insert(order.end(), next_frontier[thread].begin(), next_frontier[thread].end());
+        }
+        return next_frontier_edges;
 }
@@ -22,16 +22,125 @@
 #ifndef SHORTEST_PATHS_HQGDJB3G
 #define SHORTEST_PATHS_HQGDJB3G
 
+#include <stdint.h>
 #include <vector>
 #include "data_structure/graph_access.h"
 
+// number of sources that a multi-source BFS advances at once (bits of a word)
+const unsigned MSBFS_BATCH_SIZE = 64;
+
+// per thread buffers of the multi-source BFS, one word per node
+struct msbfs_buffers {
+        std::vector< uint64_t > seen;
+        std::vector< uint64_t > visit;
+        std::vector< uint64_t > visit_next;
+        std::vector< NodeID >   frontier;
+        std::vector< NodeID >   next_frontier;
+};
+
+// bytes per node of msbfs_buffers if the frontiers reach their maximum size
+const unsigned MSBFS_BYTES_PER_NODE = 3 * sizeof(uint64_t) + 2 * sizeof(NodeID);
+
 class shortest_paths {
 public:
         shortest_paths();
         virtual ~shortest_paths();
 
-        void one_to_many_unit_weight( graph_access & G, NodeID & source, std::vector< int > & distances);
+        // bit-parallel BFS (MS-BFS) from sources[0] ... sources[num_sources-1] (num_sources <= MSBFS_BATCH_SIZE).
+        // Instead of storing distances, visitor(i, node, distance) is called for every node and every 
+        // source sources[i], unreachable nodes get distance -1. A node is expanded once per distinct 
+        // distance to the sources, so the batch should consist of nearby sources.
+        template< typename visitor_type >
+        void multi_source_unit_weight( graph_access & G, const NodeID * sources, unsigned num_sources, 
+                                       msbfs_buffers & buffers, visitor_type & visitor );
+
+        // orders the nodes by BFS from node 0 (all components), consecutive nodes are close to each other.
+        // every component is searched with the parallel direction optimizing BFS
+        void bfs_order( graph_access & G, std::vector< NodeID > & order );
+
+private:
+        // BFS from source over the nodes with distances[node] == -1. Levels with small frontiers are expanded 
+        // top-down from the frontier, large ones bottom-up by letting every unvisited node look for a parent 
+        // in the frontier bitmap (Beamer et al.). Visited nodes are appended to order level by level,
+        // unexplored_edges is the number of edges of unvisited nodes and is updated.
+        void direction_optimizing_bfs( graph_access & G, NodeID source, std::vector< int > & distances, 
+                                       std::vector< NodeID > & order, EdgeID & unexplored_edges );
+
+        EdgeID top_down_step( graph_access & G, int deepth, std::vector< int > & distances, std::vector< NodeID > & order, 
+                              NodeID frontier_begin, NodeID frontier_end );
+
+        EdgeID bottom_up_step( graph_access & G, int deepth, std::vector< int > & distances, std::vector< NodeID > & order, 
+                               NodeID frontier_begin, NodeID frontier_end, std::vector< uint64_t > & frontier_bitmap );
 };
 
+template< typename visitor_type >
+void shortest_paths::multi_source_unit_weight( graph_access & G, const NodeID * sources, unsigned num_sources, 
+                                               msbfs_buffers & buffers, visitor_type & visitor ) {
+        std::vector< uint64_t > & seen       = buffers.seen;
+        std::vector< uint64_t > & visit      = buffers.visit;
+        std::vector< uint64_t > & visit_next = buffers.visit_next;
+        std::vector< NodeID > & frontier      = buffers.frontier;
+        std::vector< NodeID > & next_frontier = buffers.next_frontier;
+
+        seen.assign(G.number_of_nodes(), 0);
+        visit.assign(G.number_of_nodes(), 0);
+        visit_next.assign(G.number_of_nodes(), 0);
+        frontier.clear();
+
+        for( unsigned i = 0; i < num_sources; i++) {
+                NodeID source  = sources[i];
+                seen[source]  |= (uint64_t)1 << i;
+                visit[source] |= (uint64_t)1 << i;
+                frontier.push_back(source);
+                visitor(i, source, 0);
+        }
+
+        int deepth = 0;
+        while( !frontier.empty() ) {
+                deepth++;
+                next_frontier.clear();
+
+                // a node stays in the frontier only for the sources that reached it in the last round
+                for( unsigned f = 0; f < frontier.size(); f++) {
+                        NodeID node = frontier[f];
+                        forall_out_edges(G, e, node) {
+                                NodeID target = G.getEdgeTarget(e);
+                                uint64_t reached = visit[node] & ~seen[target];
+                                if( reached == 0 ) continue;
+                                if( visit_next[target] == 0 ) next_frontier.push_back(target);
+                                visit_next[target] |= reached;
+                        } endfor
+                }
+
+                for( unsigned f = 0; f < frontier.size(); f++) {
+                        visit[frontier[f]] = 0;
+                }
+
+                for( unsigned f = 0; f < next_frontier.size(); f++) {
+                        NodeID node      = next_frontier[f];
+                        uint64_t reached = visit_next[node];
+                        seen[node]      |= reached;
+                        visit[node]      = reached;
+                        visit_next[node] = 0;
+
+                        while( reached ) {
+                                unsigned i = __builtin_ctzll(reached);
+                                visitor(i, node, deepth);
+                                reached &= reached - 1;
+                        }
+                }
+                frontier.swap(next_frontier);
+        }
+
+        uint64_t all_sources = num_sources == 64 ? ~(uint64_t)0 : (((uint64_t)1 << num_sources) - 1);
+        forall_nodes(G, node) {
+                uint64_t unreached = all_sources & ~seen[node];
+                while( unreached ) {
+                        visitor(__builtin_ctzll(unreached), node, -1);
+                        unreached &= unreached - 1;
+                }
+        } endfor
+}
+
 
 #endif /* end of include guard: SHORTEST_PATHS_HQGDJB3G */
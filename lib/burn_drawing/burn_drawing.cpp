@@ -24,7 +24,15 @@
 #include <cairo.h>
 #include <cairo-pdf.h>
 #include <algorithm>
+#include <omp.h>
 #include "burn_drawing.h"
+#include "density_renderer.h"
+#include "edge_bucket_stream.h"
+#include "png_writer.h"
+#include "tile_pyramid.h"
+#include "tools/parallel_selection.h"
+#include "vector_graphics_writer.h"
+#include "tiled_rasterizer.h"
 
 
 burn_drawing::burn_drawing() {
@@ -35,13 +43,18 @@ burn_drawing::~burn_drawing() {
 
 }
 
-void burn_drawing::draw_graph( Config & config, graph_access & G) {
+bool burn_drawing::draw_graph( Config & config, graph_access & G) {
+        if( config.tile_pyramid ) {
+                tile_pyramid tp;
+                return tp.write_pyramid( config, G );
+        }
+
         GraphicsFormatType export_type = config.export_grafic_type;
 
         
         double scale            = config.image_scale;
         const double border     = 0.0;
-        const int max_dim_px    = 1200;
+        const int max_dim_px    = config.image_max_dim_px;
         const double line_width = config.linewidth;
 
         cairo_t *cr;
@@ -68,11 +81,11 @@ void burn_drawing::draw_graph( Config & config, graph_access & G) {
         if (export_type == GRAPHICS_TYPE_PNG) {
                 if (width > height) {
                         width_px = max_dim_px;
-                        height_px = round(1.0 * height / width * max_dim_px);
+                        height_px = std::max(1.0, round(1.0 * height / width * max_dim_px));
                         scale = 1.0 * max_dim_px / width;
                 } else {
                         height_px = max_dim_px;
-                        width_px = round(1.0 * width / height * max_dim_px);
+                        width_px = std::max(1.0, round(1.0 * width / height * max_dim_px));
                         scale = 1.0 * max_dim_px / height;
                 }
         }
@@ -82,6 +95,69 @@ void burn_drawing::draw_graph( Config & config, graph_access & G) {
         printf("width_px = %d, height_px = %d\n", width_px, height_px);
         printf("scale = %f\n", scale);
 
+        if (export_type == GRAPHICS_TYPE_SVG || (export_type == GRAPHICS_TYPE_PDF && config.stream_vector_output)) {
+                edge_bucket_stream buckets( config, G );
+
+                vector_view view;
+                view.x_min  = x_min - border / scale;
+                view.y_min  = y_min - border / scale;
+                view.scale  = scale;
+                view.width  = width * scale + 2 * border;
+                view.height = height * scale + 2 * border;
+
+                vector_graphics_writer writer;
+                writer.set_number_format( config.vector_precision, config.vector_quantization );
+                bool written = false;
+                if (export_type == GRAPHICS_TYPE_SVG) {
+                        written = writer.write_svg( config.output_filename, G, view, line_width, buckets );
+                } else {
+                        written = writer.write_pdf( config.output_filename, G, view, line_width, buckets );
+                }
+                if (written) {
+                        std::cout <<  "streamed " << (export_type == GRAPHICS_TYPE_SVG ? "SVG" : "PDF") << " to " << config.output_filename.c_str()  << std::endl;
+                }
+                return written;
+        }
+
+        if (export_type == GRAPHICS_TYPE_PNG && config.density_rendering) {
+                raster_view view;
+                view.x_min     = x_min - border / scale;
+                view.y_min     = y_min - border / scale;
+                view.scale     = scale;
+                view.width_px  = width_px;
+                view.height_px = height_px;
+
+                std::cout <<  "rendering density image"  << std::endl;
+                std::vector< uint32_t > image;
+                density_renderer renderer;
+                renderer.render( config, G, view, image );
+
+                std::cout <<  "writing PNG to " << config.output_filename.c_str()  << std::endl;
+                return write_png( config.output_filename, width_px, height_px, image, config.png_compression_level );
+        }
+
+        if (export_type == GRAPHICS_TYPE_PNG && config.tiled_rasterizer) {
+                std::cout <<  "rasterizing png with " << omp_get_max_threads() << " threads" << std::endl;
+                std::vector< edge_color > palette;
+                std::vector< EdgeID > bucket_start;
+                std::vector< source_target_pair > bucket_edges;
+                assign_color_buckets( config, G, palette, bucket_start, bucket_edges );
+
+                raster_view view;
+                view.x_min     = x_min - border / scale;
+                view.y_min     = y_min - border / scale;
+                view.scale     = scale;
+                view.width_px  = width_px;
+                view.height_px = height_px;
+
+                std::vector< uint32_t > image;
+                tiled_rasterizer rasterizer;
+                rasterizer.render( G, view, line_width, config.additive_blending, palette, bucket_start, bucket_edges, image );
+
+                std::cout <<  "writing PNG to " << config.output_filename.c_str()  << std::endl;
+                return write_png( config.output_filename, width_px, height_px, image, config.png_compression_level );
+        }
+
         //// Initialize Cairo surface.
         if (export_type == GRAPHICS_TYPE_PDF) {
                 surface = cairo_pdf_surface_create(config.output_filename.c_str(), width * scale + 2 * border, height * scale + 2 * border);
@@ -98,11 +174,116 @@ void burn_drawing::draw_graph( Config & config, graph_access & G) {
         cairo_scale(cr, scale, scale);
         // Initialize graphic style.
         cairo_set_line_width(cr, line_width / scale);
-        // Generate colors.
-        double r = 0.0, g = 0.0, b = 0.0;
-        cairo_set_source_rgb(cr, r, g, b);
-
         //// Now, render the graph.
+        // Each undirected edge is emitted once and edges are grouped by color, 
+        // so that every color bucket becomes a few long paths with a single stroke each. 
+        std::vector< edge_color > palette;
+        std::vector< EdgeID > bucket_start;
+        std::vector< source_target_pair > bucket_edges;
+        assign_color_buckets( config, G, palette, bucket_start, bucket_edges );
+
+        for( unsigned bucket = 0; bucket < palette.size(); bucket++) {
+                if( bucket_start[bucket] == bucket_start[bucket+1] ) continue;
+
+                cairo_set_source_rgb(cr, palette[bucket].r, palette[bucket].g, palette[bucket].b);
+                EdgeID segments = 0;
+                for( EdgeID pos = bucket_start[bucket]; pos < bucket_start[bucket+1]; pos++) {
+                        NodeID source = bucket_edges[pos].source;
+                        NodeID target = bucket_edges[pos].target;
+                        cairo_move_to(cr, G.getX(source), G.getY(source));
+                        cairo_line_to(cr, G.getX(target), G.getY(target));
+
+                        // keep the path cairo has to hold in memory bounded
+                        if( ++segments == MAX_SEGMENTS_PER_STROKE ) {
+                                cairo_stroke(cr);
+                                segments = 0;
+                        }
+                }
+                if( segments > 0 ) {
+                        cairo_stroke(cr);
+                }
+        }
+
+        bool written = true;
+        if (export_type == GRAPHICS_TYPE_PNG) {
+                std::cout <<  "writing PNG to " << config.output_filename.c_str()  << std::endl;
+                cairo_surface_flush(surface);
+                png_writer writer;
+                writer.set_compression_level( config.png_compression_level );
+                written = writer.write( config.output_filename, width_px, height_px, (uint32_t*) cairo_image_surface_get_data(surface),
+                              cairo_image_surface_get_stride(surface) / sizeof(uint32_t), true );
+        }
+
+        cairo_destroy(cr);
+        if (export_type == GRAPHICS_TYPE_PDF) {
+                // the pdf is written when the surface is finished
+                cairo_surface_finish(surface);
+                if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+                        std::cerr << "Error writing " << config.output_filename << std::endl;
+                        written = false;
+                }
+        }
+        cairo_surface_destroy(surface);
+
+        return written;
+}
+
+void burn_drawing::assign_color_buckets( Config & config, graph_access & G, 
+                                         std::vector< edge_color > & palette,
+                                         std::vector< EdgeID > & bucket_start,
+                                         std::vector< source_target_pair > & bucket_edges ) {
+
+        std::vector< EdgeID > first_edge;
+        first_undirected_edges( G, first_edge );
+        EdgeID num_undirected_edges = first_edge[G.number_of_nodes()];
+
+        edge_coloring coloring;
+        compute_edge_coloring( config, G, config.sampled_edge_length_colors, coloring );
+        palette = coloring.palette;
+
+        // bucket of every undirected edge, stored in the order edges are visited (node < target)
+        std::vector< unsigned > edge_bucket(num_undirected_edges);
+        forall_nodes_parallel(G, node) {
+                EdgeID edge_idx = first_edge[node];
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if( node > target ) continue;
+                        edge_bucket[edge_idx++] = bucket_of_edge( coloring, G, node, target );
+                } endfor
+        } endfor
+
+        // counting sort of the undirected edges by their bucket
+        bucket_start.assign(palette.size()+1, 0);
+        for( unsigned i = 0; i < edge_bucket.size(); i++) {
+                bucket_start[edge_bucket[i]+1]++;
+        }
+        for( unsigned bucket = 1; bucket < bucket_start.size(); bucket++) {
+                bucket_start[bucket] += bucket_start[bucket-1];
+        }
+
+        std::vector< EdgeID > insert_pos(bucket_start.begin(), bucket_start.end()-1);
+        bucket_edges.resize(edge_bucket.size());
+
+        unsigned edge_idx = 0;
+        forall_nodes(G, node) {
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if( node > target ) continue;
+
+                        source_target_pair & pair = bucket_edges[insert_pos[edge_bucket[edge_idx++]]++];
+                        pair.source = node;
+                        pair.target = target;
+                } endfor
+        } endfor
+}
+
+void burn_drawing::compute_edge_coloring( Config & config, graph_access & G, bool sampled, edge_coloring & coloring ) {
+        coloring.palette.clear();
+        coloring.thresholds.clear();
+        coloring.by_cluster = config.draw_initial_clustering;
+        coloring.quantiles  = config.edge_length_quantiles;
+
+        double r = 0.0, g = 0.0, b = 0.0;
         if( config.draw_initial_clustering ) {
                 int num_colors = G.get_partition_count();
                 num_colors = std::max(1, num_colors); // if no clustering should be plotted
@@ -112,107 +293,107 @@ void burn_drawing::draw_graph( Config & config, graph_access & G) {
                         hues[i] = 360.0 * i / num_colors;
                 }
 
-                forall_nodes(G, node) {
-                        double x = G.getX(node);
-                        double y = G.getY(node);
-
-                        forall_out_edges(G, e, node) {
-                                NodeID target = G.getEdgeTarget(e);
-
-                                if(G.getPartitionIndex(node) == G.getPartitionIndex(target)) {
-                                        HsvToRgb(hues[G.getPartitionIndex(node)], 0.8, 1.0, &r, &g, &b);
-                                        cairo_set_source_rgb(cr, r, g, b);
-                                } else {
-                                        if( config.light_intercluster_edges ) {
-                                                cairo_set_source_rgb(cr, 0.9, 0.9, 0.9);
-                                        } else {
-                                                cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
-                                        }
-                                }
-
-                                double x_target = G.getX(target);
-                                double y_target = G.getY(target);
-                                cairo_move_to(cr, x, y);
-                                cairo_line_to(cr, x_target, y_target);
-                                cairo_stroke(cr);
+                // intercluster edges are drawn first so that they do not cover the clusters
+                edge_color intercluster;
+                if( config.light_intercluster_edges ) {
+                        intercluster.r = intercluster.g = intercluster.b = 0.9;
+                } else {
+                        intercluster.r = intercluster.g = intercluster.b = 0.0;
+                }
+                coloring.palette.push_back(intercluster);
 
-                        } endfor
-                } endfor
-        } else {
-                // else color edges based on their length
-                int num_colors = 3;
-                std::vector<int> hues(num_colors);
-                for (int i = 1, iend = num_colors; i != iend; ++i) {
-                        hues[i] = 360.0 * (i-1) / num_colors;
+                for( int i = 0; i < num_colors; i++) {
+                        HsvToRgb(hues[i], 0.8, 1.0, &r, &g, &b);
+                        edge_color color; color.r = r; color.g = g; color.b = b;
+                        coloring.palette.push_back(color);
                 }
+                return;
+        }
 
-                std::vector< double > edge_lengths(G.number_of_edges());
-                forall_nodes(G, node) {
-                        forall_out_edges(G, e, node) {
-                                NodeID target = G.getEdgeTarget(e);
-                                edge_lengths[e] = sqrt((G.getX(node) - G.getX(target))*(G.getX(node) - G.getX(target)) + (G.getY(node) - G.getY(target))*(G.getY(node) - G.getY(target)));
-                        } endfor
+        // else color edges based on their length. either every length is stored, or, to
+        // save the array of all lengths, the thresholds are taken from every stride-th edge
+        std::vector< EdgeID > first_edge;
+        first_undirected_edges( G, first_edge );
+        EdgeID num_undirected_edges = first_edge[G.number_of_nodes()];
+
+        sampled       = sampled && num_undirected_edges > EDGE_LENGTH_SAMPLE_SIZE;
+        EdgeID stride = sampled ? (num_undirected_edges + EDGE_LENGTH_SAMPLE_SIZE - 1) / EDGE_LENGTH_SAMPLE_SIZE : 1;
+        std::vector< double > edge_lengths((num_undirected_edges + stride - 1) / stride);
+        forall_nodes_parallel(G, node) {
+                EdgeID edge_idx = first_edge[node];
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if( node > target ) continue;
+                        if( edge_idx % stride == 0 ) {
+                                edge_lengths[edge_idx / stride] = edge_length(G, node, target);
+                        }
+                        edge_idx++;
                 } endfor
+        } endfor
 
-                std::sort(edge_lengths.begin(), edge_lengths.end()); 
+        if( num_undirected_edges == 0 && !config.quiet ) {
+                std::cout <<  "attention: graph has no edges"  << std::endl;
+        }
+        if( sampled && !config.quiet ) {
+                std::cout <<  "color thresholds from " << edge_lengths.size() << " sampled edge lengths" << std::endl;
+        }
 
-                double median = 0;
-                if( G.number_of_edges() > 0 ) {
-                        if( edge_lengths.size() % 2 == 0) {
-                                median += edge_lengths[edge_lengths.size()/2-1];
-                                median += edge_lengths[edge_lengths.size()/2];
-                                median /= 2;
-                        } else {
-                                median = edge_lengths[edge_lengths.size()/2];
-                        }
-                } else {
-                        std::cout <<  "attention: graph has no edges"  << std::endl;
+        parallel_selection selection;
+        if( config.edge_length_quantiles > 1 ) {
+                // quantile color ramp from blue (shortest edges) to red (longest edges)
+                int num_colors = config.edge_length_quantiles;
+                for( int i = 0; i < num_colors; i++) {
+                        HsvToRgb(240.0 * (num_colors - 1 - i) / (num_colors - 1), 0.8, 0.9, &r, &g, &b);
+                        edge_color color; color.r = r; color.g = g; color.b = b;
+                        coloring.palette.push_back(color);
                 }
 
-                forall_nodes(G, node) {
-                        double x = G.getX(node);
-                        double y = G.getY(node);
-
-                        forall_out_edges(G, e, node) {
-                                NodeID target = G.getEdgeTarget(e);
-
-                                double distance   = (G.getX(node) - G.getX(target))*(G.getX(node) - G.getX(target));
-                                distance         += (G.getY(node) - G.getY(target))*(G.getY(node) - G.getY(target));
-                                distance          = sqrt(distance);
-
-                                if(distance < 0.5*median) {
-                                        HsvToRgb(hues[1], 0.8, 1.0, &r, &g, &b);
-                                } else if (distance > 1.5*median) {
-                                        HsvToRgb(hues[1], 0.8, .75, &r, &g, &b);
-                                } else {
-                                        //interpolate
-                                        //double alpha = 0;
-                                        //if( distance > median ) {
-                                                //alpha = (1.5*median - distance)/median;
-                                        //} else {
-                                                //alpha = (distance-0.5*median)/median;
-                                        //}
-                                        HsvToRgb(hues[2], 0.9, .5, &r, &g, &b);
-                                }
-                                cairo_set_source_rgb(cr, r, g, b);
-
-                                double x_target = G.getX(target);
-                                double y_target = G.getY(target);
-                                cairo_move_to(cr, x, y);
-                                cairo_line_to(cr, x_target, y_target);
-                                cairo_stroke(cr);
+                std::vector< EdgeID > ranks;
+                for( int i = 1; i < num_colors; i++) {
+                        ranks.push_back((EdgeID)((double)i * edge_lengths.size() / num_colors));
+                }
+                selection.select(edge_lengths, ranks, coloring.thresholds);
+        } else {
+                int num_colors = 3;
+                std::vector<int> hues(num_colors);
+                for (int i = 1, iend = num_colors; i != iend; ++i) {
+                        hues[i] = 360.0 * (i-1) / num_colors;
+                }
 
-                        } endfor
-                } endfor       
+                // short, long and medium edges
+                edge_color color;
+                HsvToRgb(hues[1], 0.8, 1.0, &r, &g, &b);
+                color.r = r; color.g = g; color.b = b;
+                coloring.palette.push_back(color);
+                HsvToRgb(hues[1], 0.8, .75, &r, &g, &b);
+                color.r = r; color.g = g; color.b = b;
+                coloring.palette.push_back(color);
+                HsvToRgb(hues[2], 0.9, .5, &r, &g, &b);
+                color.r = r; color.g = g; color.b = b;
+                coloring.palette.push_back(color);
+
+                double median = selection.median(edge_lengths);
+                coloring.thresholds.push_back(0.5*median);
+                coloring.thresholds.push_back(1.5*median);
         }
+}
 
-        if (export_type == GRAPHICS_TYPE_PNG) {
-                std::cout <<  "writing PNG to " << config.output_filename.c_str()  << std::endl;
-                cairo_surface_write_to_png(surface, config.output_filename.c_str());
+void burn_drawing::first_undirected_edges( graph_access & G, std::vector< EdgeID > & first_edge ) {
+        first_edge.assign(G.number_of_nodes()+1, 0);
+        forall_nodes_parallel(G, node) {
+                EdgeID count = 0;
+                forall_out_edges(G, e, node) {
+                        if( node < G.getEdgeTarget(e) ) count++;
+                } endfor
+                first_edge[node+1] = count;
+        } endfor
+        for( NodeID node = 0; node < G.number_of_nodes(); node++) {
+                first_edge[node+1] += first_edge[node];
         }
+}
 
-        cairo_destroy(cr);
-        cairo_surface_destroy(surface);
-
-
+bool burn_drawing::write_png( std::string filename, int width_px, int height_px, std::vector< uint32_t > & image, int compression_level ) {
+        png_writer writer;
+        writer.set_compression_level( compression_level );
+        return writer.write( filename, width_px, height_px, &image[0], width_px, false );
 }
@@ -23,9 +23,34 @@
 #ifndef BURN_DRAWING_UORVQGB6
 #define BURN_DRAWING_UORVQGB6
 
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
 #include "config.h"
 #include "data_structure/graph_access.h"
 
+// maximum number of line segments that are collected in a single cairo path
+const EdgeID MAX_SEGMENTS_PER_STROKE = 100000;
+
+// number of edge lengths the color thresholds are computed from if sampled_edge_length_colors is set
+const EdgeID EDGE_LENGTH_SAMPLE_SIZE = 1 << 20;
+
+struct edge_color {
+        double r;
+        double g;
+        double b;
+};
+
+// colors of the edges. if by_cluster, bucket 0 holds the intercluster edges and bucket c+1 
+// the edges within cluster c, else the buckets are separated by the length thresholds
+struct edge_coloring {
+        std::vector< edge_color > palette;
+        bool by_cluster;
+        int quantiles;
+        std::vector< double > thresholds;
+};
 
 
 class burn_drawing {
@@ -33,7 +58,45 @@ public:
         burn_drawing();
         virtual ~burn_drawing();
 
-        void draw_graph( Config & config, graph_access & G);
+        // false if the output could not be written
+        bool draw_graph( Config & config, graph_access & G);
+
+        // groups the undirected edges by color, bucket i consists of the edges 
+        // bucket_edges[bucket_start[i]] ... bucket_edges[bucket_start[i+1]-1] 
+        void assign_color_buckets( Config & config, graph_access & G, 
+                                   std::vector< edge_color > & palette,
+                                   std::vector< EdgeID > & bucket_start,
+                                   std::vector< source_target_pair > & bucket_edges );
+
+        // palette and length thresholds, if sampled the thresholds are taken from 
+        // EDGE_LENGTH_SAMPLE_SIZE evenly spaced edges instead of all edges
+        void compute_edge_coloring( Config & config, graph_access & G, bool sampled, edge_coloring & coloring );
+
+        static double edge_length( graph_access & G, NodeID node, NodeID target ) {
+                return sqrt((G.getX(node) - G.getX(target))*(G.getX(node) - G.getX(target)) + (G.getY(node) - G.getY(target))*(G.getY(node) - G.getY(target)));
+        }
+
+        static unsigned bucket_of_edge( const edge_coloring & coloring, graph_access & G, NodeID node, NodeID target ) {
+                if( coloring.by_cluster ) {
+                        if( G.getPartitionIndex(node) == G.getPartitionIndex(target) ) {
+                                return G.getPartitionIndex(node) + 1;
+                        }
+                        return 0;
+                }
+
+                double distance = edge_length(G, node, target);
+                if( coloring.quantiles > 1 ) {
+                        return std::upper_bound(coloring.thresholds.begin(), coloring.thresholds.end(), distance) - coloring.thresholds.begin();
+                } else if( distance < coloring.thresholds[0] ) {
+                        return 0;
+                } else if( distance > coloring.thresholds[1] ) {
+                        return 1;
+                }
+                return 2;
+        }
+
+        // writes an ARGB32 image with the parallel png encoder
+        bool write_png( std::string filename, int width_px, int height_px, std::vector< uint32_t > & image, int compression_level );
 
 	void HsvToRgb(int h, double s, double v, double *r, double *g, double *b) {
 		double H, S, V, R, G, B;
@@ -63,6 +126,11 @@ public:
 		*g = G;
 		*b = B;
 	}
+
+private:
+        // position of the first undirected edge (node < target) of every node, 
+        // first_edge[n] is the number of undirected edges
+        void first_undirected_edges( graph_access & G, std::vector< EdgeID > & first_edge );
 };
 
 
@@ -0,0 +1,164 @@
+/******************************************************************************
+ * density_renderer.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <math.h>
+#include <omp.h>
+
+#include "density_renderer.h"
+
+const int TONE_MAPPING_HISTOGRAM_BINS = 4096;
+
+density_renderer::density_renderer() {
+
+}
+
+density_renderer::~density_renderer() {
+
+}
+
+void density_renderer::render( const Config & config, graph_access & G, const raster_view & view, std::vector< uint32_t > & image ) {
+        std::vector< float > density((size_t)view.width_px * view.height_px, 0.0f);
+
+        if( config.density_of_nodes ) {
+                accumulate_nodes( G, view, density );
+        } else {
+                accumulate_edges( G, view, density );
+        }
+
+        tone_map( density, config.tone_mapping, image );
+}
+
+void density_renderer::accumulate_edges( graph_access & G, const raster_view & view, std::vector< float > & density ) {
+        forall_nodes_parallel(G, node) {
+                double x0 = (G.getX(node) - view.x_min) * view.scale;
+                double y0 = (G.getY(node) - view.y_min) * view.scale;
+
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if( node > target ) continue;
+
+                        double x1 = (G.getX(target) - view.x_min) * view.scale;
+                        double y1 = (G.getY(target) - view.y_min) * view.scale;
+
+                        // DDA along the major axis, the weight of a step is split
+                        // between the two pixels next to the line on the minor axis
+                        bool x_major = fabs(x1 - x0) >= fabs(y1 - y0);
+                        double a0 = x_major ? x0 : y0;
+                        double a1 = x_major ? x1 : y1;
+                        double b0 = x_major ? y0 : x0;
+                        double b1 = x_major ? y1 : x1;
+                        if( a0 > a1 ) {
+                                std::swap(a0, a1);
+                                std::swap(b0, b1);
+                        }
+
+                        int major_size = x_major ? view.width_px : view.height_px;
+                        int lo = std::max(0, (int)floor(a0));
+                        int hi = std::min(major_size - 1, (int)floor(a1));
+                        if( a1 - a0 < 1e-12 ) {
+                                add( density, view, (int)floor(x0), (int)floor(y0), 1.0f );
+                                continue;
+                        }
+
+                        double slope = (b1 - b0) / (a1 - a0);
+                        float step   = sqrt(1 + slope*slope);
+                        for( int a = lo; a <= hi; a++) {
+                                double b    = b0 + slope * (a + 0.5 - a0) - 0.5;
+                                int b_floor = (int)floor(b);
+                                float frac  = b - b_floor;
+                                if( x_major ) {
+                                        add( density, view, a, b_floor,     (1 - frac) * step );
+                                        add( density, view, a, b_floor + 1, frac * step );
+                                } else {
+                                        add( density, view, b_floor,     a, (1 - frac) * step );
+                                        add( density, view, b_floor + 1, a, frac * step );
+                                }
+                        }
+                } endfor
+        } endfor
+}
+
+void density_renderer::accumulate_nodes( graph_access & G, const raster_view & view, std::vector< float > & density ) {
+        forall_nodes_parallel(G, node) {
+                // nodes on the right and lower border of the view belong to the last pixel
+                int x = std::min(view.width_px - 1,  (int)floor((G.getX(node) - view.x_min) * view.scale));
+                int y = std::min(view.height_px - 1, (int)floor((G.getY(node) - view.y_min) * view.scale));
+                add( density, view, x, y, 1.0f );
+        } endfor
+}
+
+void density_renderer::tone_map( const std::vector< float > & density, ToneMappingType tone_mapping, std::vector< uint32_t > & image ) {
+        long num_pixels = density.size();
+        image.resize(num_pixels);
+
+        float max_density = 0;
+        #pragma omp parallel for reduction(max:max_density)
+        for( long p = 0; p < num_pixels; p++) {
+                max_density = std::max(max_density, density[p]);
+        }
+        if( max_density <= 0 ) max_density = 1;
+
+        // both mappings first compress the dynamic range logarithmically
+        double log_max = log1p(max_density);
+        std::vector< double > cdf;
+        if( tone_mapping == TONE_MAPPING_HISTOGRAM ) {
+                // histogram of the non empty pixels, each thread fills its own histogram
+                int num_threads = omp_get_max_threads();
+                std::vector< std::vector< long > > local_histogram(num_threads, std::vector< long >(TONE_MAPPING_HISTOGRAM_BINS, 0));
+                #pragma omp parallel for
+                for( long p = 0; p < num_pixels; p++) {
+                        if( density[p] <= 0 ) continue;
+                        int bin = std::min(TONE_MAPPING_HISTOGRAM_BINS - 1, (int)(log1p(density[p]) / log_max * TONE_MAPPING_HISTOGRAM_BINS));
+                        local_histogram[omp_get_thread_num()][bin]++;
+                }
+
+                cdf.resize(TONE_MAPPING_HISTOGRAM_BINS, 0);
+                double total = 0;
+                for( int bin = 0; bin < TONE_MAPPING_HISTOGRAM_BINS; bin++) {
+                        for( int thread = 0; thread < num_threads; thread++) {
+                                total += local_histogram[thread][bin];
+                        }
+                        cdf[bin] = total;
+                }
+                for( int bin = 0; bin < TONE_MAPPING_HISTOGRAM_BINS; bin++) {
+                        cdf[bin] /= std::max(1.0, total);
+                }
+        }
+
+        #pragma omp parallel for
+        for( long p = 0; p < num_pixels; p++) {
+                double value = 0;
+                if( density[p] > 0 ) {
+                        value = log1p(density[p]) / log_max;
+                        if( tone_mapping == TONE_MAPPING_HISTOGRAM ) {
+                                int bin = std::min(TONE_MAPPING_HISTOGRAM_BINS - 1, (int)(value * TONE_MAPPING_HISTOGRAM_BINS));
+                                value = cdf[bin];
+                        }
+                }
+
+                // white for empty pixels, dark blue for the densest ones
+                uint32_t r = (uint32_t)(255 * (1 - 0.95 * value) + 0.5);
+                uint32_t g = (uint32_t)(255 * (1 - 0.90 * value) + 0.5);
+                uint32_t b = (uint32_t)(255 * (1 - 0.55 * value) + 0.5);
+                image[p] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+}
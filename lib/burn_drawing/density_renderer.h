@@ -0,0 +1,65 @@
+/******************************************************************************
+ * density_renderer.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DENSITY_RENDERER_H3XKQ0WP
+#define DENSITY_RENDERER_H3XKQ0WP
+
+#include <stdint.h>
+#include <vector>
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+#include "tiled_rasterizer.h"
+
+// Renders graphs that have far more edges than the image has pixels.
+// Instead of stroking every edge, the edge coverage (or the node density)
+// is accumulated into a float buffer and then tone mapped to gray values.
+class density_renderer {
+public:
+        density_renderer();
+        virtual ~density_renderer();
+
+        void render( const Config & config, graph_access & G, const raster_view & view, std::vector< uint32_t > & image );
+
+        // adds the length of every edge that falls into a pixel to its density value
+        void accumulate_edges( graph_access & G, const raster_view & view, std::vector< float > & density );
+
+        // counts the nodes per pixel
+        void accumulate_nodes( graph_access & G, const raster_view & view, std::vector< float > & density );
+
+        // maps the density values to an opaque ARGB32 image
+        void tone_map( const std::vector< float > & density, ToneMappingType tone_mapping, std::vector< uint32_t > & image );
+
+private:
+        inline void add( std::vector< float > & density, const raster_view & view, int x, int y, float value );
+};
+
+inline void density_renderer::add( std::vector< float > & density, const raster_view & view, int x, int y, float value ) {
+        if( x < 0 || y < 0 || x >= view.width_px || y >= view.height_px ) return;
+
+        float & pixel = density[(size_t)y * view.width_px + x];
+        #pragma omp atomic
+        pixel += value;
+}
+
+
+#endif /* end of include guard: DENSITY_RENDERER_H3XKQ0WP */
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * edge_bucket_stream.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#include "edge_bucket_stream.h"
+
+edge_bucket_stream::edge_bucket_stream( Config & config, graph_access & G ) : m_G(G) {
+        burn_drawing bd;
+        bd.compute_edge_coloring( config, G, true, m_coloring );
+        if( !m_coloring.by_cluster ) return;
+
+        // counting sort of the nodes by cluster, nodes stay in increasing order
+        PartitionID num_clusters = m_coloring.palette.size() - 1;
+        m_cluster_start.assign(num_clusters + 1, 0);
+        forall_nodes(G, node) {
+                m_cluster_start[G.getPartitionIndex(node) + 1]++;
+        } endfor
+        for( PartitionID cluster = 0; cluster < num_clusters; cluster++) {
+                m_cluster_start[cluster+1] += m_cluster_start[cluster];
+        }
+
+        std::vector< NodeID > insert_pos(m_cluster_start.begin(), m_cluster_start.end() - 1);
+        m_cluster_nodes.resize(G.number_of_nodes());
+        forall_nodes(G, node) {
+                m_cluster_nodes[insert_pos[G.getPartitionIndex(node)]++] = node;
+        } endfor
+}
+
+edge_bucket_stream::~edge_bucket_stream() {
+
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * edge_bucket_stream.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef EDGE_BUCKET_STREAM_M3XC8TQH
+#define EDGE_BUCKET_STREAM_M3XC8TQH
+
+#include <vector>
+
+#include "burn_drawing.h"
+
+// Visits the undirected edges of G bucket by bucket in the order of 
+// burn_drawing::assign_color_buckets without storing them. A length bucket is 
+// found by a pass over all edges, a cluster bucket through the nodes of its 
+// cluster, so the memory only grows with the number of nodes. The length 
+// thresholds are taken from a sample of EDGE_LENGTH_SAMPLE_SIZE edges.
+class edge_bucket_stream {
+public:
+        edge_bucket_stream( Config & config, graph_access & G );
+        virtual ~edge_bucket_stream();
+
+        unsigned number_of_buckets() const { return m_coloring.palette.size(); }
+        const edge_color & color( unsigned bucket ) const { return m_coloring.palette[bucket]; }
+
+        // calls visit(source, target) for every edge of the bucket
+        template< typename visitor >
+        void visit_bucket( unsigned bucket, visitor visit ) const;
+
+private:
+        graph_access & m_G;
+        edge_coloring  m_coloring;
+
+        // nodes of cluster c are m_cluster_nodes[m_cluster_start[c]] ... m_cluster_nodes[m_cluster_start[c+1]-1]
+        std::vector< NodeID > m_cluster_start;
+        std::vector< NodeID > m_cluster_nodes;
+};
+
+template< typename visitor >
+void edge_bucket_stream::visit_bucket( unsigned bucket, visitor visit ) const {
+        if( m_coloring.by_cluster && bucket > 0 ) {
+                PartitionID cluster = bucket - 1;
+                for( NodeID i = m_cluster_start[cluster]; i < m_cluster_start[cluster+1]; i++) {
+                        NodeID node = m_cluster_nodes[i];
+                        forall_out_edges(m_G, e, node) {
+                                NodeID target = m_G.getEdgeTarget(e);
+                                if( node > target || m_G.getPartitionIndex(target) != cluster ) continue;
+                                visit(node, target);
+                        } endfor
+                }
+                return;
+        }
+
+        forall_nodes(m_G, node) {
+                forall_out_edges(m_G, e, node) {
+                        NodeID target = m_G.getEdgeTarget(e);
+                        if( node > target ) continue;
+                        if( burn_drawing::bucket_of_edge( m_coloring, m_G, node, target ) == bucket ) {
+                                visit(node, target);
+                        }
+                } endfor
+        } endfor
+}
+
+
+#endif /* end of include guard: EDGE_BUCKET_STREAM_M3XC8TQH */
@@ -0,0 +1,227 @@
+/******************************************************************************
+ * png_writer.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+#include <omp.h>
+#include <zlib.h>
+
+#include "png_writer.h"
+
+static void put_uint32( unsigned char * target, uint32_t value ) {
+        target[0] = value >> 24;
+        target[1] = value >> 16;
+        target[2] = value >> 8;
+        target[3] = value;
+}
+
+png_writer::png_writer() : m_level(6) {
+
+}
+
+png_writer::~png_writer() {
+
+}
+
+bool png_writer::write( std::string filename, int width_px, int height_px,
+                        const uint32_t * pixels, int stride, bool premultiplied ) {
+        bool has_alpha = false;
+        #pragma omp parallel for reduction(||:has_alpha)
+        for( int y = 0; y < height_px; y++) {
+                for( int x = 0; x < width_px; x++) {
+                        if( (pixels[(size_t)y * stride + x] >> 24) != 0xFF ) has_alpha = true;
+                }
+        }
+
+        int    level          = std::max(0, std::min(9, m_level));
+        size_t row_bytes      = 1 + (size_t)width_px * (has_alpha ? 4 : 3);
+        int    rows_per_block = std::max((size_t)1, PNG_BLOCK_SIZE / row_bytes);
+        int    dict_rows      = (PNG_DICTIONARY_SIZE + row_bytes - 1) / row_bytes;
+        int    num_blocks     = (height_px + rows_per_block - 1) / rows_per_block;
+
+        std::vector< std::vector< unsigned char > > compressed(num_blocks);
+        std::vector< uLong > block_adler(num_blocks);
+        std::vector< size_t > block_length(num_blocks);
+        bool failed = false;
+
+        #pragma omp parallel
+        {
+                std::vector< unsigned char > raw;
+                #pragma omp for schedule(dynamic, 1) reduction(||:failed)
+                for( int block = 0; block < num_blocks; block++) {
+                        // the rows in front of the block are converted as well to rebuild the dictionary
+                        int begin      = block * rows_per_block;
+                        int end        = std::min(height_px, begin + rows_per_block);
+                        int dict_begin = std::max(0, begin - dict_rows);
+                        convert_scanlines( width_px, end - dict_begin, pixels + (size_t)dict_begin * stride, stride,
+                                           premultiplied, has_alpha, raw );
+
+                        size_t dict_length = (size_t)(begin - dict_begin) * row_bytes;
+                        size_t length      = (size_t)(end - begin) * row_bytes;
+                        unsigned char * data = &raw[0] + dict_length;
+
+                        z_stream stream;
+                        stream.zalloc = Z_NULL;
+                        stream.zfree  = Z_NULL;
+                        stream.opaque = Z_NULL;
+                        if( deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK ) {
+                                failed = true;
+                                continue;
+                        }
+                        if( dict_length > 0 ) {
+                                size_t used = std::min(dict_length, PNG_DICTIONARY_SIZE);
+                                deflateSetDictionary(&stream, data - used, used);
+                        }
+
+                        std::vector< unsigned char > & out = compressed[block];
+                        out.resize(deflateBound(&stream, length) + 16);
+                        stream.next_in   = data;
+                        stream.avail_in  = length;
+                        stream.next_out  = &out[0];
+                        stream.avail_out = out.size();
+
+                        int flush = block + 1 == num_blocks ? Z_FINISH : Z_SYNC_FLUSH;
+                        int state = deflate(&stream, flush);
+                        while( stream.avail_out == 0 && state != Z_STREAM_END ) {
+                                size_t written = out.size();
+                                out.resize(2 * out.size());
+                                stream.next_out  = &out[written];
+                                stream.avail_out = out.size() - written;
+                                state = deflate(&stream, flush);
+                        }
+                        block_length[block] = out.size() - stream.avail_out;
+                        deflateEnd(&stream);
+
+                        block_adler[block] = adler32(adler32(0L, Z_NULL, 0), data, length);
+                }
+        }
+
+        if( failed ) {
+                std::cerr << "Error initializing zlib" << std::endl;
+                return false;
+        }
+
+        FILE * file = fopen(filename.c_str(), "wb");
+        if( file == NULL ) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return false;
+        }
+
+        const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        fwrite(signature, 1, 8, file);
+
+        unsigned char header[13];
+        put_uint32(header, width_px);
+        put_uint32(header + 4, height_px);
+        header[8]  = 8;                     // bit depth
+        header[9]  = has_alpha ? 6 : 2;     // RGBA or RGB
+        header[10] = 0;                     // deflate
+        header[11] = 0;                     // adaptive filtering
+        header[12] = 0;                     // no interlacing
+        write_chunk(file, "IHDR", header, 13);
+
+        // zlib header, the pieces and the combined checksum are split into IDAT chunks
+        std::vector< unsigned char > idat;
+        idat.reserve(PNG_MAX_CHUNK_SIZE);
+        idat.push_back(0x78);
+        idat.push_back(level <= 1 ? 0x01 : (level <= 5 ? 0x5E : (level == 6 ? 0x9C : 0xDA)));
+
+        uLong adler = adler32(0L, Z_NULL, 0);
+        for( int block = 0; block < num_blocks; block++) {
+                adler = adler32_combine(adler, block_adler[block], (z_off_t)(std::min(height_px, (block + 1) * rows_per_block) - block * rows_per_block) * row_bytes);
+
+                for( size_t pos = 0; pos < block_length[block]; ) {
+                        size_t count = std::min(block_length[block] - pos, PNG_MAX_CHUNK_SIZE - idat.size());
+                        idat.insert(idat.end(), compressed[block].begin() + pos, compressed[block].begin() + pos + count);
+                        pos += count;
+                        if( idat.size() == PNG_MAX_CHUNK_SIZE ) {
+                                write_chunk(file, "IDAT", &idat[0], idat.size());
+                                idat.clear();
+                        }
+                }
+                std::vector< unsigned char >().swap(compressed[block]);
+        }
+
+        unsigned char checksum[4];
+        put_uint32(checksum, adler);
+        idat.insert(idat.end(), checksum, checksum + 4);
+        write_chunk(file, "IDAT", &idat[0], idat.size());
+        write_chunk(file, "IEND", NULL, 0);
+
+        // a short write (e.g. a full disk) sets the error indicator of the file
+        bool ok = !ferror(file);
+        if( fclose(file) != 0 ) {
+                ok = false;
+        }
+        if( !ok ) {
+                std::cerr << "Error writing " << filename << std::endl;
+        }
+        return ok;
+}
+
+void png_writer::convert_scanlines( int width_px, int height_px, const uint32_t * pixels, int stride,
+                                    bool premultiplied, bool has_alpha, std::vector< unsigned char > & raw ) {
+        int    bpp       = has_alpha ? 4 : 3;
+        size_t row_bytes = 1 + (size_t)width_px * bpp;
+        raw.resize(row_bytes * height_px);
+
+        for( int y = 0; y < height_px; y++) {
+                unsigned char * row = &raw[y * row_bytes];
+                row[0] = 0;
+                for( int x = 0; x < width_px; x++) {
+                        uint32_t pixel = pixels[(size_t)y * stride + x];
+                        uint32_t a = pixel >> 24;
+                        uint32_t r = (pixel >> 16) & 0xFF;
+                        uint32_t g = (pixel >> 8) & 0xFF;
+                        uint32_t b = pixel & 0xFF;
+                        if( premultiplied && a != 0xFF ) {
+                                if( a == 0 ) {
+                                        r = g = b = 0;
+                                } else {
+                                        r = (r * 255 + a / 2) / a;
+                                        g = (g * 255 + a / 2) / a;
+                                        b = (b * 255 + a / 2) / a;
+                                }
+                        }
+                        unsigned char * target = row + 1 + (size_t)x * bpp;
+                        target[0] = r;
+                        target[1] = g;
+                        target[2] = b;
+                        if( has_alpha ) target[3] = a;
+                }
+        }
+}
+
+void png_writer::write_chunk( FILE * file, const char * type, const unsigned char * data, size_t length ) {
+        unsigned char length_bytes[4];
+        put_uint32(length_bytes, length);
+        fwrite(length_bytes, 1, 4, file);
+        fwrite(type, 1, 4, file);
+        if( length > 0 ) fwrite(data, 1, length, file);
+
+        uLong crc = crc32(0L, Z_NULL, 0);
+        crc = crc32(crc, (const Bytef*) type, 4);
+        if( length > 0 ) crc = crc32(crc, data, length);
+
+        unsigned char crc_bytes[4];
+        put_uint32(crc_bytes, crc);
+        fwrite(crc_bytes, 1, 4, file);
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * png_writer.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef PNG_WRITER_R5TJ2WXN
+#define PNG_WRITER_R5TJ2WXN
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// size of the uncompressed pieces of the image that are deflated independently
+const size_t PNG_BLOCK_SIZE = 1 << 18;
+
+// the last 32KB of the previous piece prime the dictionary of the next one
+const size_t PNG_DICTIONARY_SIZE = 1 << 15;
+
+// maximum length of a single IDAT chunk
+const size_t PNG_MAX_CHUNK_SIZE = 1 << 20;
+
+// Multi-threaded PNG encoder for ARGB32 images (cairo's pixel format).
+// The scanlines are split into pieces which are deflated in parallel.
+// Every piece but the last ends with a sync flush at a byte boundary so that the
+// raw deflate streams can be concatenated into one zlib stream (like pigz does).
+class png_writer {
+public:
+        png_writer();
+        virtual ~png_writer();
+
+        // compression level of zlib, 0 only stores the data and 1 is the fastest compression
+        void set_compression_level( int level ) { m_level = level; }
+
+        // stride is the distance of two rows in pixels, premultiplied alpha (cairo) is undone.
+        // false if the file could not be written completely
+        bool write( std::string filename, int width_px, int height_px,
+                    const uint32_t * pixels, int stride, bool premultiplied );
+
+private:
+        // converts rows to RGB(A) scanlines with filter type none, which compresses
+        // drawings with large white areas better than the predicting filters
+        void convert_scanlines( int width_px, int height_px, const uint32_t * pixels, int stride,
+                                bool premultiplied, bool has_alpha, std::vector< unsigned char > & raw );
+
+        void write_chunk( FILE * file, const char * type, const unsigned char * data, size_t length );
+
+        int m_level;
+};
+
+
+#endif /* end of include guard: PNG_WRITER_R5TJ2WXN */
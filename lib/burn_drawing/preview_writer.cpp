@@ -0,0 +1,118 @@
+/******************************************************************************
+ * preview_writer.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <omp.h>
+#include <sstream>
+
+#include "burn_drawing.h"
+#include "density_renderer.h"
+#include "graph_io.h"
+#include "png_writer.h"
+#include "preview_writer.h"
+#include "tiled_rasterizer.h"
+
+preview_writer::preview_writer() {
+
+}
+
+preview_writer::~preview_writer() {
+        wait();
+}
+
+void preview_writer::write_preview( const Config & config, graph_access & G, int level ) {
+        if( G.number_of_nodes() == 0 ) return;
+        wait();
+
+        graph_access * snapshot = new graph_access();
+        G.copy(*snapshot);
+        forall_nodes(G, node) {
+                snapshot->setCoords(node, G.getX(node), G.getY(node));
+        } endfor
+
+        m_thread = std::thread(&preview_writer::render, this, config, snapshot, level);
+}
+
+void preview_writer::wait() {
+        if( m_thread.joinable() ) {
+                m_thread.join();
+        }
+}
+
+void preview_writer::render( Config config, graph_access * snapshot, int level ) {
+        // the optimizer keeps all cores busy and owns stdout
+        omp_set_num_threads(1);
+        config.quiet = true;
+        graph_access & G = *snapshot;
+
+        double x_min = G.getX(0);
+        double x_max = G.getX(0);
+        double y_min = G.getY(0);
+        double y_max = G.getY(0);
+        forall_nodes(G, node) {
+                x_min = std::min(x_min, G.getX(node));
+                x_max = std::max(x_max, G.getX(node));
+                y_min = std::min(y_min, G.getY(node));
+                y_max = std::max(y_max, G.getY(node));
+        } endfor
+
+        double side = std::max(x_max - x_min, y_max - y_min);
+        if( side <= 0 ) side = 1;
+
+        raster_view view;
+        view.x_min     = x_min;
+        view.y_min     = y_min;
+        view.scale     = PREVIEW_MAX_DIM_PX / side;
+        view.width_px  = std::max(1, (int)round((x_max - x_min) * view.scale));
+        view.height_px = std::max(1, (int)round((y_max - y_min) * view.scale));
+
+        std::vector< uint32_t > image;
+        if( config.preview_density ) {
+                density_renderer renderer;
+                renderer.render( config, G, view, image );
+        } else {
+                config.draw_initial_clustering = false;
+
+                std::vector< edge_color > palette;
+                std::vector< EdgeID > bucket_start;
+                std::vector< source_target_pair > bucket_edges;
+                burn_drawing bd;
+                bd.assign_color_buckets( config, G, palette, bucket_start, bucket_edges );
+
+                tiled_rasterizer rasterizer;
+                rasterizer.render( G, view, config.linewidth, false, palette, bucket_start, bucket_edges, image );
+        }
+
+        std::stringstream filename;
+        filename << config.preview_prefix << "_level" << level;
+
+        png_writer writer;
+        writer.set_compression_level(1);
+        if( !writer.write( filename.str() + ".png", view.width_px, view.height_px, &image[0], view.width_px, false ) ) {
+                std::cerr << "Error writing the preview of level " << level << std::endl;
+        }
+
+        if( config.preview_coordinates ) {
+                graph_io::writeCoordinates( G, filename.str() + ".coord" );
+        }
+
+        delete snapshot;
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * preview_writer.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef PREVIEW_WRITER_M6DW3QZC
+#define PREVIEW_WRITER_M6DW3QZC
+
+#include <thread>
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+
+// size of the larger side of preview images in pixels
+const int PREVIEW_MAX_DIM_PX = 800;
+
+// Writes a cheap png (and optionally the coordinates) of the current level during
+// uncoarsening. The level is copied and then drawn by a single background thread,
+// so that the optimizer only pays for the copy. A new preview first waits for the
+// previous one to be finished.
+class preview_writer {
+public:
+        preview_writer();
+        virtual ~preview_writer();
+
+        void write_preview( const Config & config, graph_access & G, int level );
+
+        // blocks until the last preview has been written
+        void wait();
+
+private:
+        void render( Config config, graph_access * snapshot, int level );
+
+        std::thread m_thread;
+};
+
+
+#endif /* end of include guard: PREVIEW_WRITER_M6DW3QZC */
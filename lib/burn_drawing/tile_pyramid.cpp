@@ -0,0 +1,252 @@
+/******************************************************************************
+ * tile_pyramid.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <errno.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "burn_drawing.h"
+#include "tile_pyramid.h"
+#include "tiled_rasterizer.h"
+#include "tools/timer.h"
+
+static bool compare_pairs( const source_target_pair & lhs, const source_target_pair & rhs ) {
+        return lhs.source < rhs.source || (lhs.source == rhs.source && lhs.target < rhs.target);
+}
+
+static bool equal_pairs( const source_target_pair & lhs, const source_target_pair & rhs ) {
+        return lhs.source == rhs.source && lhs.target == rhs.target;
+}
+
+tile_pyramid::tile_pyramid() {
+
+}
+
+tile_pyramid::~tile_pyramid() {
+
+}
+
+bool tile_pyramid::write_pyramid( Config & config, graph_access & G ) {
+        if( G.number_of_nodes() == 0 ) return true;
+
+        double x_min = G.getX(0);
+        double x_max = G.getX(0);
+        double y_min = G.getY(0);
+        double y_max = G.getY(0);
+
+        forall_nodes(G, node) {
+                x_min = std::min(x_min, G.getX(node));
+                x_max = std::max(x_max, G.getX(node));
+                y_min = std::min(y_min, G.getY(node));
+                y_max = std::max(y_max, G.getY(node));
+        } endfor
+
+        // tiles are square, so the drawing is placed in the upper left corner of a square world
+        double side = std::max(x_max - x_min, y_max - y_min);
+        if( side <= 0 ) side = 1;
+
+        graph_access Q;
+        bool draw_quotient = config.tile_coarse_zoom > 0 && G.get_partition_count() > 1;
+        if( draw_quotient ) {
+                build_quotient_graph( G, Q );
+                std::cout <<  "quotient graph for coarse zoom levels has " << Q.number_of_nodes()
+                          <<  " nodes and " << Q.number_of_edges()/2 << " edges" << std::endl;
+        }
+
+        create_directory( config.tile_directory );
+        for( int zoom = 0; zoom <= config.tile_max_zoom; zoom++) {
+                bool written = false;
+                if( draw_quotient && zoom < config.tile_coarse_zoom ) {
+                        written = write_zoom_level( config, Q, zoom, x_min, y_min, side );
+                } else {
+                        written = write_zoom_level( config, G, zoom, x_min, y_min, side );
+                }
+                if( !written ) return false;
+        }
+        return true;
+}
+
+bool tile_pyramid::write_zoom_level( Config & config, graph_access & G, int zoom,
+                                     double x_min, double y_min, double side ) {
+        timer t;
+        burn_drawing bd;
+
+        // only the coloring by edge length makes sense for quotient graphs
+        Config cfg = config;
+        if( G.get_partition_count() <= 1 ) {
+                cfg.draw_initial_clustering = false;
+        }
+
+        std::vector< edge_color > palette;
+        std::vector< EdgeID > bucket_start;
+        std::vector< source_target_pair > bucket_edges;
+        bd.assign_color_buckets( cfg, G, palette, bucket_start, bucket_edges );
+
+        TileID tiles_per_side = (TileID)1 << zoom;
+        raster_view view;
+        view.x_min     = x_min;
+        view.y_min     = y_min;
+        view.width_px  = tiles_per_side * RASTER_TILE_SIZE;
+        view.height_px = tiles_per_side * RASTER_TILE_SIZE;
+        view.scale     = view.width_px / side;
+
+        std::stringstream zoom_dir;
+        zoom_dir << config.tile_directory << "/" << zoom;
+        create_directory( zoom_dir.str() );
+
+        tiled_rasterizer rasterizer;
+        rasterizer.set_additive_blending( config.additive_blending );
+        TileID num_written = 0;
+        bool   written     = true;
+        if( zoom <= TILE_REGION_ZOOM ) {
+                rasterizer.bin_edges( G, view, config.linewidth, bucket_edges );
+                written     = write_tiles( config, G, rasterizer, zoom_dir.str(), tiles_per_side, palette, bucket_start, bucket_edges );
+                num_written = rasterizer.number_of_nonempty_tiles();
+        } else {
+                // the regions are the tiles of zoom level TILE_REGION_ZOOM. their margin is wider
+                // than the one of the deep level, so a region gets every edge that touches its tiles
+                raster_view region_view = view;
+                region_view.width_px    = (1 << TILE_REGION_ZOOM) * RASTER_TILE_SIZE;
+                region_view.height_px   = region_view.width_px;
+                region_view.scale       = region_view.width_px / side;
+
+                tiled_rasterizer regions;
+                regions.bin_edges( G, region_view, config.linewidth, bucket_edges );
+
+                unsigned region_side = 1 << (zoom - TILE_REGION_ZOOM);
+                std::vector< EdgeID > region_edges;
+                for( TileID r = 0; r < regions.number_of_nonempty_tiles() && written; r++) {
+                        TileID region = regions.nonempty_tile(r);
+                        regions.tile_edges( r, region_edges );
+
+                        tile_window window;
+                        window.col_lo = (region % regions.tiles_x()) * region_side;
+                        window.row_lo = (region / regions.tiles_x()) * region_side;
+                        window.col_hi = window.col_lo + region_side;
+                        window.row_hi = window.row_lo + region_side;
+                        rasterizer.bin_edges( G, view, config.linewidth, bucket_edges, window, region_edges );
+                        written      = write_tiles( config, G, rasterizer, zoom_dir.str(), tiles_per_side, palette, bucket_start, bucket_edges );
+                        num_written += rasterizer.number_of_nonempty_tiles();
+                }
+        }
+
+        std::cout <<  "zoom level " << zoom << ": wrote " << num_written << " of " << tiles_per_side * tiles_per_side
+                  <<  " tiles in " << t.elapsed() << std::endl;
+        return written;
+}
+
+bool tile_pyramid::write_tiles( Config & config, graph_access & G, tiled_rasterizer & rasterizer,
+                                const std::string & zoom_dir, TileID tiles_per_side,
+                                const std::vector< edge_color > & palette,
+                                const std::vector< EdgeID > & bucket_start,
+                                const std::vector< source_target_pair > & bucket_edges ) {
+        burn_drawing bd;
+
+        // only the columns that contain a non empty tile get a directory
+        long num_tiles = rasterizer.number_of_nonempty_tiles();
+        std::vector< TileID > columns(num_tiles);
+        for( long i = 0; i < num_tiles; i++) {
+                columns[i] = rasterizer.nonempty_tile(i) % tiles_per_side;
+        }
+        std::sort( columns.begin(), columns.end() );
+        columns.erase( std::unique( columns.begin(), columns.end() ), columns.end() );
+        for( unsigned i = 0; i < columns.size(); i++) {
+                std::stringstream x_dir;
+                x_dir << zoom_dir << "/" << columns[i];
+                create_directory( x_dir.str() );
+        }
+
+        bool failed = false;
+        #pragma omp parallel
+        {
+                std::vector< uint32_t > tile_pixels;
+                #pragma omp for schedule(dynamic, 1) reduction(||:failed)
+                for( long i = 0; i < num_tiles; i++) {
+                        TileID tile = rasterizer.nonempty_tile(i);
+                        rasterizer.render_tile( G, i, palette, bucket_start, bucket_edges, tile_pixels );
+
+                        std::stringstream filename;
+                        filename << zoom_dir << "/" << tile % tiles_per_side << "/" << tile / tiles_per_side << ".png";
+                        if( !bd.write_png( filename.str(), RASTER_TILE_SIZE, RASTER_TILE_SIZE, tile_pixels, config.png_compression_level ) ) {
+                                failed = true;
+                        }
+                }
+        }
+        return !failed;
+}
+
+void tile_pyramid::build_quotient_graph( graph_access & G, graph_access & Q ) {
+        PartitionID k = G.get_partition_count();
+
+        std::vector< double > centroid_x(k, 0);
+        std::vector< double > centroid_y(k, 0);
+        std::vector< NodeWeight > cluster_weight(k, 0);
+        std::vector< source_target_pair > quotient_edges;
+
+        forall_nodes(G, node) {
+                PartitionID block = G.getPartitionIndex(node);
+                centroid_x[block]     += G.getNodeWeight(node) * G.getX(node);
+                centroid_y[block]     += G.getNodeWeight(node) * G.getY(node);
+                cluster_weight[block] += G.getNodeWeight(node);
+
+                forall_out_edges(G, e, node) {
+                        PartitionID target_block = G.getPartitionIndex(G.getEdgeTarget(e));
+                        if( block == target_block ) continue;
+
+                        source_target_pair pair;
+                        pair.source = block;
+                        pair.target = target_block;
+                        quotient_edges.push_back(pair);
+                } endfor
+        } endfor
+
+        std::sort( quotient_edges.begin(), quotient_edges.end(), compare_pairs );
+        quotient_edges.erase( std::unique( quotient_edges.begin(), quotient_edges.end(), equal_pairs ),
+                              quotient_edges.end() );
+
+        Q.start_construction(k, quotient_edges.size());
+        unsigned pos = 0;
+        for( PartitionID block = 0; block < k; block++) {
+                NodeID node = Q.new_node();
+                Q.setNodeWeight(node, cluster_weight[block]);
+                Q.setPartitionIndex(node, 0);
+                if( cluster_weight[block] > 0 ) {
+                        Q.setCoords(node, centroid_x[block] / cluster_weight[block], centroid_y[block] / cluster_weight[block]);
+                } else {
+                        Q.setCoords(node, 0, 0);
+                }
+
+                for( ; pos < quotient_edges.size() && quotient_edges[pos].source == block; pos++) {
+                        EdgeID e = Q.new_edge(node, quotient_edges[pos].target);
+                        Q.setEdgeWeight(e, 1);
+                }
+        }
+        Q.finish_construction();
+        Q.set_partition_count(1);
+}
+
+void tile_pyramid::create_directory( const std::string & path ) {
+        if( mkdir(path.c_str(), 0755) != 0 && errno != EEXIST ) {
+                std::cerr << "Error creating directory " << path << std::endl;
+        }
+}
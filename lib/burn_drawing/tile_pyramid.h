@@ -0,0 +1,69 @@
+/******************************************************************************
+ * tile_pyramid.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef TILE_PYRAMID_B2XWQ8LN
+#define TILE_PYRAMID_B2XWQ8LN
+
+#include <string>
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+#include "tiled_rasterizer.h"
+
+// deepest supported zoom level, the pixel coordinates of a level have to fit into an int
+const int MAX_TILE_ZOOM = 22;
+
+// deeper zoom levels are binned and rendered one region (a tile of this level) at a time,
+// the (tile, edge) pairs of a deep level do not fit into memory at once
+const int TILE_REGION_ZOOM = 8;
+
+// Writes a drawing as XYZ tile pyramid (tile_directory/z/x/y.png) that can be
+// browsed with web map viewers. Zoom level z consists of 2^z x 2^z tiles of
+// RASTER_TILE_SIZE pixels, empty tiles are not written.
+class tile_pyramid {
+public:
+        tile_pyramid();
+        virtual ~tile_pyramid();
+
+        // false if a tile could not be written
+        bool write_pyramid( Config & config, graph_access & G );
+
+private:
+        bool write_zoom_level( Config & config, graph_access & G, int zoom,
+                               double x_min, double y_min, double side );
+
+        // renders and writes the non empty tiles of the binned rasterizer, false if a tile could not be written
+        bool write_tiles( Config & config, graph_access & G, tiled_rasterizer & rasterizer,
+                          const std::string & zoom_dir, TileID tiles_per_side,
+                          const std::vector< edge_color > & palette,
+                          const std::vector< EdgeID > & bucket_start,
+                          const std::vector< source_target_pair > & bucket_edges );
+
+        // contracts the clustering stored in the partition indices of G,
+        // coarse nodes are placed at the centroid of their cluster
+        void build_quotient_graph( graph_access & G, graph_access & Q );
+
+        void create_directory( const std::string & path );
+};
+
+
+#endif /* end of include guard: TILE_PYRAMID_B2XWQ8LN */
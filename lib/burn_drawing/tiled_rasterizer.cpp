@@ -0,0 +1,320 @@
+/******************************************************************************
+ * tiled_rasterizer.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <math.h>
+#include <omp.h>
+
+#include "tiled_rasterizer.h"
+
+tiled_rasterizer::tiled_rasterizer() : m_line_width(1), m_additive_blending(false), m_tiles_x(0), m_tiles_y(0) {
+
+}
+
+tiled_rasterizer::~tiled_rasterizer() {
+
+}
+
+// collects the tiles of window that a segment (in pixel coordinates) touches when drawn with the given margin
+static void touched_tiles( double x0, double y0, double x1, double y1, double margin,
+                           unsigned tiles_x, const tile_window & window, std::vector< TileID > & tiles ) {
+        tiles.clear();
+
+        double y_lo = std::min(y0, y1) - margin;
+        double y_hi = std::max(y0, y1) + margin;
+        double x_lo = std::min(x0, x1) - margin;
+        double x_hi = std::max(x0, x1) + margin;
+        if( y_hi < (double)window.row_lo*RASTER_TILE_SIZE || x_hi < (double)window.col_lo*RASTER_TILE_SIZE 
+         || y_lo >= (double)window.row_hi*RASTER_TILE_SIZE || x_lo >= (double)window.col_hi*RASTER_TILE_SIZE ) return;
+
+        int row_lo = std::max((int)window.row_lo, (int)floor(y_lo / RASTER_TILE_SIZE));
+        int row_hi = std::min((int)window.row_hi-1, (int)floor(y_hi / RASTER_TILE_SIZE));
+
+        double dy = y1 - y0;
+        for( int row = row_lo; row <= row_hi; row++) {
+                // part of the segment that lies in the horizontal band of this tile row
+                double band_lo = (double)row * RASTER_TILE_SIZE - margin;
+                double band_hi = (double)(row + 1) * RASTER_TILE_SIZE + margin;
+                double seg_x_lo = x_lo;
+                double seg_x_hi = x_hi;
+                if( fabs(dy) > 1e-12 ) {
+                        double t_a = (band_lo - y0) / dy;
+                        double t_b = (band_hi - y0) / dy;
+                        double t_lo = std::max(0.0, std::min(t_a, t_b));
+                        double t_hi = std::min(1.0, std::max(t_a, t_b));
+                        if( t_lo > t_hi ) continue;
+
+                        double xa = x0 + t_lo * (x1 - x0);
+                        double xb = x0 + t_hi * (x1 - x0);
+                        seg_x_lo = std::min(xa, xb) - margin;
+                        seg_x_hi = std::max(xa, xb) + margin;
+                }
+
+                int col_lo = std::max((int)window.col_lo, (int)floor(seg_x_lo / RASTER_TILE_SIZE));
+                int col_hi = std::min((int)window.col_hi-1, (int)floor(seg_x_hi / RASTER_TILE_SIZE));
+                for( int col = col_lo; col <= col_hi; col++) {
+                        tiles.push_back((TileID)row * tiles_x + col);
+                }
+        }
+}
+
+static bool compare_entries( const tile_entry & lhs, const tile_entry & rhs ) {
+        return lhs.tile < rhs.tile || (lhs.tile == rhs.tile && lhs.edge < rhs.edge);
+}
+
+void tiled_rasterizer::bin_edges( graph_access & G, const raster_view & view, double line_width,
+                                  const std::vector< source_target_pair > & bucket_edges ) {
+        tile_window window;
+        window.col_lo = 0;
+        window.row_lo = 0;
+        window.col_hi = (view.width_px  + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        window.row_hi = (view.height_px + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        bin( G, view, line_width, bucket_edges, window, NULL );
+}
+
+void tiled_rasterizer::bin_edges( graph_access & G, const raster_view & view, double line_width,
+                                  const std::vector< source_target_pair > & bucket_edges,
+                                  const tile_window & window, const std::vector< EdgeID > & edges ) {
+        bin( G, view, line_width, bucket_edges, window, &edges );
+}
+
+void tiled_rasterizer::tile_edges( TileID i, std::vector< EdgeID > & edges ) {
+        edges.clear();
+        for( size_t entry = m_tile_start[i]; entry < m_tile_start[i+1]; entry++) {
+                edges.push_back(m_entries[entry].edge);
+        }
+}
+
+// edges == NULL means all edges of bucket_edges
+void tiled_rasterizer::bin( graph_access & G, const raster_view & view, double line_width,
+                            const std::vector< source_target_pair > & bucket_edges,
+                            const tile_window & window, const std::vector< EdgeID > * edges ) {
+        m_view       = view;
+        m_line_width = line_width;
+        m_tiles_x    = (view.width_px  + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        m_tiles_y    = (view.height_px + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+
+        int num_threads      = omp_get_max_threads();
+        EdgeID num_edges     = edges == NULL ? bucket_edges.size() : edges->size();
+        double margin        = line_width / 2 + 1;
+
+        // first pass: every thread counts the (tile, edge) pairs of its (static) range of edges.
+        // pairs are counted with size_t, a large view has many more pairs than edges
+        std::vector< size_t > thread_start(num_threads+1, 0);
+        #pragma omp parallel num_threads(num_threads)
+        {
+                std::vector< TileID > tiles;
+                size_t count = 0;
+                #pragma omp for schedule(static)
+                for( EdgeID i = 0; i < num_edges; i++) {
+                        EdgeID pos    = edges == NULL ? i : (*edges)[i];
+                        NodeID source = bucket_edges[pos].source;
+                        NodeID target = bucket_edges[pos].target;
+                        touched_tiles( (G.getX(source) - view.x_min) * view.scale, (G.getY(source) - view.y_min) * view.scale,
+                                       (G.getX(target) - view.x_min) * view.scale, (G.getY(target) - view.y_min) * view.scale,
+                                       margin, m_tiles_x, window, tiles);
+                        count += tiles.size();
+                }
+                thread_start[omp_get_thread_num()+1] = count;
+        }
+        for( int thread = 0; thread < num_threads; thread++) {
+                thread_start[thread+1] += thread_start[thread];
+        }
+        m_entries.resize(thread_start[num_threads]);
+
+        // second pass: same static schedule, write the pairs and sort them per thread
+        #pragma omp parallel num_threads(num_threads)
+        {
+                std::vector< TileID > tiles;
+                int thread = omp_get_thread_num();
+                size_t insert_pos = thread_start[thread];
+                #pragma omp for schedule(static)
+                for( EdgeID i = 0; i < num_edges; i++) {
+                        EdgeID pos    = edges == NULL ? i : (*edges)[i];
+                        NodeID source = bucket_edges[pos].source;
+                        NodeID target = bucket_edges[pos].target;
+                        touched_tiles( (G.getX(source) - view.x_min) * view.scale, (G.getY(source) - view.y_min) * view.scale,
+                                       (G.getX(target) - view.x_min) * view.scale, (G.getY(target) - view.y_min) * view.scale,
+                                       margin, m_tiles_x, window, tiles);
+                        for( unsigned t = 0; t < tiles.size(); t++) {
+                                m_entries[insert_pos].tile = tiles[t];
+                                m_entries[insert_pos].edge = pos;
+                                insert_pos++;
+                        }
+                }
+                std::sort( m_entries.begin() + thread_start[thread], m_entries.begin() + thread_start[thread+1], compare_entries );
+        }
+
+        // merge the sorted ranges of the threads pairwise
+        for( int width = 1; width < num_threads; width *= 2) {
+                #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+                for( int first = 0; first < num_threads - width; first += 2 * width) {
+                        int last = std::min(num_threads, first + 2 * width);
+                        std::inplace_merge( m_entries.begin() + thread_start[first],
+                                            m_entries.begin() + thread_start[first + width],
+                                            m_entries.begin() + thread_start[last], compare_entries );
+                }
+        }
+
+        m_tiles.clear();
+        m_tile_start.clear();
+        for( size_t i = 0; i < m_entries.size(); i++) {
+                if( i == 0 || m_entries[i].tile != m_entries[i-1].tile ) {
+                        m_tiles.push_back(m_entries[i].tile);
+                        m_tile_start.push_back(i);
+                }
+        }
+        m_tile_start.push_back(m_entries.size());
+}
+
+void tiled_rasterizer::render_tile( graph_access & G, TileID i,
+                                    const std::vector< edge_color > & palette,
+                                    const std::vector< EdgeID > & bucket_start,
+                                    const std::vector< source_target_pair > & bucket_edges,
+                                    std::vector< uint32_t > & tile_pixels ) {
+
+        TileID tile     = m_tiles[i];
+        double origin_x = (double)(tile % m_tiles_x) * RASTER_TILE_SIZE;
+        double origin_y = (double)(tile / m_tiles_x) * RASTER_TILE_SIZE;
+
+        // white background
+        std::vector< float > rgb(3 * RASTER_TILE_SIZE * RASTER_TILE_SIZE, 1.0f);
+
+        unsigned bucket = 0;
+        for( size_t entry = m_tile_start[i]; entry < m_tile_start[i+1]; entry++) {
+                EdgeID pos = m_entries[entry].edge;
+                while( pos >= bucket_start[bucket+1] ) bucket++;
+
+                NodeID source = bucket_edges[pos].source;
+                NodeID target = bucket_edges[pos].target;
+                draw_segment( (G.getX(source) - m_view.x_min) * m_view.scale - origin_x,
+                              (G.getY(source) - m_view.y_min) * m_view.scale - origin_y,
+                              (G.getX(target) - m_view.x_min) * m_view.scale - origin_x,
+                              (G.getY(target) - m_view.y_min) * m_view.scale - origin_y,
+                              palette[bucket], rgb);
+        }
+
+        tile_pixels.resize(RASTER_TILE_SIZE * RASTER_TILE_SIZE);
+        for( unsigned p = 0; p < tile_pixels.size(); p++) {
+                uint32_t r = (uint32_t)(std::min(1.0f, std::max(0.0f, rgb[3*p]))   * 255 + 0.5f);
+                uint32_t g = (uint32_t)(std::min(1.0f, std::max(0.0f, rgb[3*p+1])) * 255 + 0.5f);
+                uint32_t b = (uint32_t)(std::min(1.0f, std::max(0.0f, rgb[3*p+2])) * 255 + 0.5f);
+                tile_pixels[p] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+}
+
+void tiled_rasterizer::render( graph_access & G, const raster_view & view, double line_width, bool additive_blending,
+                               const std::vector< edge_color > & palette,
+                               const std::vector< EdgeID > & bucket_start,
+                               const std::vector< source_target_pair > & bucket_edges,
+                               std::vector< uint32_t > & image ) {
+
+        m_additive_blending = additive_blending;
+        bin_edges( G, view, line_width, bucket_edges );
+
+        // tiles without edges stay white
+        image.assign((size_t)view.width_px * view.height_px, 0xFFFFFFFFu);
+        long num_tiles = number_of_nonempty_tiles();
+
+        #pragma omp parallel
+        {
+                std::vector< uint32_t > tile_pixels;
+                #pragma omp for schedule(dynamic, 1)
+                for( long i = 0; i < num_tiles; i++) {
+                        render_tile( G, i, palette, bucket_start, bucket_edges, tile_pixels );
+
+                        TileID tile  = m_tiles[i];
+                        int origin_x = (tile % m_tiles_x) * RASTER_TILE_SIZE;
+                        int origin_y = (tile / m_tiles_x) * RASTER_TILE_SIZE;
+                        int cols     = std::min(RASTER_TILE_SIZE, view.width_px  - origin_x);
+                        int rows     = std::min(RASTER_TILE_SIZE, view.height_px - origin_y);
+                        for( int row = 0; row < rows; row++) {
+                                std::copy( tile_pixels.begin() + row * RASTER_TILE_SIZE,
+                                           tile_pixels.begin() + row * RASTER_TILE_SIZE + cols,
+                                           image.begin() + (size_t)(origin_y + row) * view.width_px + origin_x );
+                        }
+                }
+        }
+}
+
+// draws an antialiased segment (tile local pixel coordinates) into a tile buffer,
+// the coverage of a pixel is derived from the distance of its center to the segment
+void tiled_rasterizer::draw_segment( double x0, double y0, double x1, double y1,
+                                     const edge_color & color, std::vector< float > & rgb ) {
+        double dx     = x1 - x0;
+        double dy     = y1 - y0;
+        double len_sq = dx*dx + dy*dy;
+        double half   = m_line_width / 2;
+        bool x_major  = fabs(dx) >= fabs(dy);
+
+        // iterate over the major axis, and a small window around the line on the minor axis
+        double major_lo = (x_major ? std::min(x0, x1) : std::min(y0, y1)) - half - 1;
+        double major_hi = (x_major ? std::max(x0, x1) : std::max(y0, y1)) + half + 1;
+        int lo = std::max(0, (int)floor(major_lo));
+        int hi = std::min(RASTER_TILE_SIZE-1, (int)floor(major_hi));
+
+        double len    = sqrt(len_sq);
+        double extent = len_sq > 1e-18 ? (half + 1) * len / (x_major ? fabs(dx) : fabs(dy)) : half + 1;
+
+        for( int major = lo; major <= hi; major++) {
+                double center = major + 0.5;
+                double minor_center;
+                if( len_sq > 1e-18 ) {
+                        minor_center = x_major ? y0 + (center - x0) * dy / dx : x0 + (center - y0) * dx / dy;
+                } else {
+                        minor_center = x_major ? y0 : x0;
+                }
+
+                int minor_lo = std::max(0, (int)floor(minor_center - extent));
+                int minor_hi = std::min(RASTER_TILE_SIZE-1, (int)floor(minor_center + extent));
+                for( int minor = minor_lo; minor <= minor_hi; minor++) {
+                        double px = (x_major ? major : minor) + 0.5;
+                        double py = (x_major ? minor : major) + 0.5;
+
+                        // distance of the pixel center to the segment
+                        double t = len_sq > 1e-18 ? ((px - x0) * dx + (py - y0) * dy) / len_sq : 0;
+                        t = std::max(0.0, std::min(1.0, t));
+                        double ex = px - (x0 + t * dx);
+                        double ey = py - (y0 + t * dy);
+                        double dist = sqrt(ex*ex + ey*ey);
+
+                        double coverage = 0;
+                        if( m_line_width >= 1 ) {
+                                coverage = std::max(0.0, std::min(1.0, half + 0.5 - dist));
+                        } else {
+                                coverage = m_line_width * std::max(0.0, 1.0 - dist);
+                        }
+                        if( coverage <= 0 ) continue;
+
+                        float * pixel = &rgb[3 * ((x_major ? minor : major) * RASTER_TILE_SIZE + (x_major ? major : minor))];
+                        if( m_additive_blending ) {
+                                // overlapping edges accumulate ink
+                                pixel[0] -= (1 - color.r) * coverage;
+                                pixel[1] -= (1 - color.g) * coverage;
+                                pixel[2] -= (1 - color.b) * coverage;
+                        } else {
+                                pixel[0] += (color.r - pixel[0]) * coverage;
+                                pixel[1] += (color.g - pixel[1]) * coverage;
+                                pixel[2] += (color.b - pixel[2]) * coverage;
+                        }
+                }
+        }
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * tiled_rasterizer.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef TILED_RASTERIZER_Q7MZ2KDE
+#define TILED_RASTERIZER_Q7MZ2KDE
+
+#include <stdint.h>
+#include <vector>
+
+#include "burn_drawing.h"
+
+const int RASTER_TILE_SIZE = 256;
+
+// tiles are numbered row by row, deep zoom levels of a tile pyramid have more than 2^32 tiles
+typedef uint64_t TileID;
+
+// an edge (position in the color buckets) that touches a tile
+struct tile_entry {
+        TileID tile;
+        EdgeID edge;
+};
+
+// rectangle of tiles [col_lo, col_hi) x [row_lo, row_hi) of a view
+struct tile_window {
+        unsigned col_lo;
+        unsigned row_lo;
+        unsigned col_hi;
+        unsigned row_hi;
+};
+
+// maps graph coordinates to pixels: px = (x - x_min) * scale
+struct raster_view {
+        double x_min;
+        double y_min;
+        double scale;
+        int width_px;
+        int height_px;
+};
+
+// Software rasterizer for png output. The edges are binned into square
+// screen tiles in parallel and every tile is then drawn independently by
+// one thread with antialiased lines. Pixels are stored as opaque ARGB32.
+// Only tiles that are touched by an edge are stored, so the memory does not
+// depend on the number of tiles of the view.
+class tiled_rasterizer {
+public:
+        tiled_rasterizer();
+        virtual ~tiled_rasterizer();
+
+        // sorts the edges (given as color buckets, see burn_drawing::assign_color_buckets)
+        // into the tiles of the view, edges keep their relative order within a tile.
+        // the (tile, edge) pairs of every thread are sorted and then merged pairwise.
+        void bin_edges( graph_access & G, const raster_view & view, double line_width,
+                        const std::vector< source_target_pair > & bucket_edges );
+
+        // bins only the given edges (increasing positions in bucket_edges) into the tiles of window, 
+        // tiles keep their ids in the whole view. the memory is bounded by the pairs of the window
+        void bin_edges( graph_access & G, const raster_view & view, double line_width,
+                        const std::vector< source_target_pair > & bucket_edges,
+                        const tile_window & window, const std::vector< EdgeID > & edges );
+
+        // draws the i-th non empty tile into tile_pixels (RASTER_TILE_SIZE^2 pixels, row major)
+        void render_tile( graph_access & G, TileID i,
+                          const std::vector< edge_color > & palette,
+                          const std::vector< EdgeID > & bucket_start,
+                          const std::vector< source_target_pair > & bucket_edges,
+                          std::vector< uint32_t > & tile_pixels );
+
+        // renders all tiles in parallel and composites them into image (width_px*height_px pixels)
+        void render( graph_access & G, const raster_view & view, double line_width, bool additive_blending,
+                     const std::vector< edge_color > & palette,
+                     const std::vector< EdgeID > & bucket_start,
+                     const std::vector< source_target_pair > & bucket_edges,
+                     std::vector< uint32_t > & image );
+
+        TileID number_of_tiles() { return (TileID)m_tiles_x * m_tiles_y; }
+        unsigned tiles_x() { return m_tiles_x; }
+        unsigned tiles_y() { return m_tiles_y; }
+
+        // tiles that are touched by at least one edge, in increasing order
+        TileID number_of_nonempty_tiles() { return m_tiles.size(); }
+        TileID nonempty_tile( TileID i ) { return m_tiles[i]; }
+
+        // positions (in bucket_edges) of the edges of the i-th non empty tile, in increasing order
+        void tile_edges( TileID i, std::vector< EdgeID > & edges );
+
+        void set_additive_blending( bool additive ) { m_additive_blending = additive; }
+
+private:
+        void bin( graph_access & G, const raster_view & view, double line_width,
+                  const std::vector< source_target_pair > & bucket_edges,
+                  const tile_window & window, const std::vector< EdgeID > * edges );
+
+        void draw_segment( double x0, double y0, double x1, double y1,
+                           const edge_color & color, std::vector< float > & rgb );
+
+        raster_view m_view;
+        double      m_line_width;
+        bool        m_additive_blending;
+        unsigned    m_tiles_x;
+        unsigned    m_tiles_y;
+
+        // the i-th non empty tile is m_tiles[i], its edges are
+        // m_entries[m_tile_start[i]] ... m_entries[m_tile_start[i+1]-1]
+        std::vector< TileID >     m_tiles;
+        std::vector< size_t >     m_tile_start;
+        std::vector< tile_entry > m_entries;
+};
+
+
+#endif /* end of include guard: TILED_RASTERIZER_Q7MZ2KDE */
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * vector_graphics_writer.cpp
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+
+#include "vector_graphics_writer.h"
+
+vector_graphics_writer::vector_graphics_writer() : m_file(NULL), m_buffer(VECTOR_OUTPUT_BUFFER_SIZE),
+                                                   m_fill(0), m_written(0), m_stream_start(0), m_failed(false) {
+        set_number_format(2, 0);
+}
+
+vector_graphics_writer::~vector_graphics_writer() {
+        close();
+}
+
+void vector_graphics_writer::set_number_format( int precision, double quantization ) {
+        m_precision        = std::max(0, std::min(9, precision));
+        m_precision_factor = 1;
+        for( int i = 0; i < m_precision; i++) {
+                m_precision_factor *= 10;
+        }
+        m_quantization = quantization;
+}
+
+bool vector_graphics_writer::write_svg( std::string filename, graph_access & G, const vector_view & view, double line_width,
+                                        const edge_bucket_stream & buckets ) {
+        if( !open(filename) ) return false;
+
+        char text[512];
+        snprintf(text, sizeof(text),
+                 "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                 "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%g\" height=\"%g\" viewBox=\"0 0 %g %g\">\n"
+                 "<rect width=\"100%%\" height=\"100%%\" fill=\"#ffffff\"/>\n"
+                 "<g fill=\"none\" stroke-width=\"%g\">\n",
+                 view.width, view.height, view.width, view.height, line_width);
+        append(text);
+
+        for( unsigned bucket = 0; bucket < buckets.number_of_buckets(); bucket++) {
+                const edge_color & color = buckets.color(bucket);
+                snprintf(text, sizeof(text), "<path stroke=\"#%02x%02x%02x\" d=\"",
+                         (int)(255 * color.r + 0.5), (int)(255 * color.g + 0.5), (int)(255 * color.b + 0.5));
+
+                EdgeID segments = 0;
+                buckets.visit_bucket( bucket, [&]( NodeID source, NodeID target ) {
+                        double x0 = quantize((G.getX(source) - view.x_min) * view.scale);
+                        double y0 = quantize((G.getY(source) - view.y_min) * view.scale);
+                        double x1 = quantize((G.getX(target) - view.x_min) * view.scale);
+                        double y1 = quantize((G.getY(target) - view.y_min) * view.scale);
+                        if( m_quantization > 0 && x0 == x1 && y0 == y1 ) return;
+
+                        if( segments == 0 ) append(text);
+                        append("M"); append_number(x0); append(" "); append_number(y0);
+                        append("L"); append_number(x1); append(" "); append_number(y1);
+
+                        if( ++segments == MAX_SEGMENTS_PER_STROKE ) {
+                                append("\"/>\n");
+                                segments = 0;
+                        }
+                });
+                if( segments > 0 ) {
+                        append("\"/>\n");
+                }
+        }
+
+        append("</g>\n</svg>\n");
+        if( !close() ) {
+                std::cerr << "Error writing " << filename << std::endl;
+                return false;
+        }
+        return true;
+}
+
+bool vector_graphics_writer::write_pdf( std::string filename, graph_access & G, const vector_view & view, double line_width,
+                                        const edge_bucket_stream & buckets ) {
+        if( !open(filename) ) return false;
+
+        // objects 1-3 are catalog, page tree and page, the page is written last since it
+        // references the content streams. every content stream is followed by its length.
+        std::vector< long > object_offset(4, 0);
+        std::vector< int >  content_objects;
+        char text[512];
+
+        append("%PDF-1.4\n%\xe2\xe3\xcf\xd3\n");
+        object_offset[1] = offset();
+        append("1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+        object_offset[2] = offset();
+        append("2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n");
+
+        begin_content_stream( object_offset, content_objects );
+        snprintf(text, sizeof(text), "1 1 1 rg 0 0 %g %g re f\n%g w\n", view.width, view.height, line_width);
+        append(text);
+        end_content_stream( object_offset, content_objects );
+
+        for( unsigned bucket = 0; bucket < buckets.number_of_buckets(); bucket++) {
+                const edge_color & color = buckets.color(bucket);
+                snprintf(text, sizeof(text), "%.4g %.4g %.4g RG\n", color.r, color.g, color.b);
+
+                EdgeID segments = 0;
+                buckets.visit_bucket( bucket, [&]( NodeID source, NodeID target ) {
+                        // pdf coordinates grow upwards
+                        double x0 = quantize((G.getX(source) - view.x_min) * view.scale);
+                        double y0 = quantize(view.height - (G.getY(source) - view.y_min) * view.scale);
+                        double x1 = quantize((G.getX(target) - view.x_min) * view.scale);
+                        double y1 = quantize(view.height - (G.getY(target) - view.y_min) * view.scale);
+                        if( m_quantization > 0 && x0 == x1 && y0 == y1 ) return;
+
+                        if( segments == 0 ) {
+                                begin_content_stream( object_offset, content_objects );
+                                append(text);
+                        }
+                        append_number(x0); append(" "); append_number(y0); append(" m ");
+                        append_number(x1); append(" "); append_number(y1); append(" l\n");
+
+                        if( ++segments == MAX_SEGMENTS_PER_STROKE ) {
+                                append("S\n");
+                                end_content_stream( object_offset, content_objects );
+                                segments = 0;
+                        }
+                });
+                if( segments > 0 ) {
+                        append("S\n");
+                        end_content_stream( object_offset, content_objects );
+                }
+        }
+
+        object_offset[3] = offset();
+        snprintf(text, sizeof(text), "3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 %g %g] /Resources << >> /Contents [",
+                 view.width, view.height);
+        append(text);
+        for( unsigned i = 0; i < content_objects.size(); i++) {
+                snprintf(text, sizeof(text), " %d 0 R", content_objects[i]);
+                append(text);
+        }
+        append(" ] >>\nendobj\n");
+
+        long xref_offset = offset();
+        snprintf(text, sizeof(text), "xref\n0 %d\n0000000000 65535 f \n", (int)object_offset.size());
+        append(text);
+        for( unsigned object = 1; object < object_offset.size(); object++) {
+                snprintf(text, sizeof(text), "%010ld 00000 n \n", object_offset[object]);
+                append(text);
+        }
+        snprintf(text, sizeof(text), "trailer\n<< /Size %d /Root 1 0 R >>\nstartxref\n%ld\n%%%%EOF\n",
+                 (int)object_offset.size(), xref_offset);
+        append(text);
+
+        if( !close() ) {
+                std::cerr << "Error writing " << filename << std::endl;
+                return false;
+        }
+        return true;
+}
+
+void vector_graphics_writer::begin_content_stream( std::vector< long > & object_offset, std::vector< int > & content_objects ) {
+        int object = object_offset.size();
+        object_offset.push_back(offset());
+        object_offset.push_back(0);
+        content_objects.push_back(object);
+
+        char text[128];
+        snprintf(text, sizeof(text), "%d 0 obj\n<< /Length %d 0 R >>\nstream\n", object, object + 1);
+        append(text);
+        m_stream_start = offset();
+}
+
+void vector_graphics_writer::end_content_stream( std::vector< long > & object_offset, std::vector< int > & content_objects ) {
+        // the length is only known now, so it is stored in an object of its own.
+        // streams always end with a newline which does not count to the data.
+        long length = offset() - m_stream_start - 1;
+        append("endstream\nendobj\n");
+
+        int object = content_objects.back() + 1;
+        object_offset[object] = offset();
+        char text[128];
+        snprintf(text, sizeof(text), "%d 0 obj\n%ld\nendobj\n", object, length);
+        append(text);
+}
+
+bool vector_graphics_writer::open( std::string & filename ) {
+        close();
+        m_file = fopen(filename.c_str(), "wb");
+        if( m_file == NULL ) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return false;
+        }
+        m_fill    = 0;
+        m_written = 0;
+        m_failed  = false;
+        return true;
+}
+
+bool vector_graphics_writer::close() {
+        if( m_file == NULL ) return !m_failed;
+
+        flush();
+        if( fclose(m_file) != 0 ) {
+                m_failed = true;
+        }
+        m_file = NULL;
+        return !m_failed;
+}
+
+void vector_graphics_writer::flush() {
+        if( m_file != NULL && m_fill > 0 ) {
+                // a short write (e.g. a full disk) is remembered and reported by close
+                if( fwrite(&m_buffer[0], 1, m_fill, m_file) != m_fill ) {
+                        m_failed = true;
+                }
+        }
+        m_written += m_fill;
+        m_fill     = 0;
+}
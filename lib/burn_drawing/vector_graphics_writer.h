@@ -0,0 +1,146 @@
+/******************************************************************************
+ * vector_graphics_writer.h
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef VECTOR_GRAPHICS_WRITER_K4PZ7RYA
+#define VECTOR_GRAPHICS_WRITER_K4PZ7RYA
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "burn_drawing.h"
+#include "edge_bucket_stream.h"
+
+// size of the output buffer, everything else is written to disk directly
+const size_t VECTOR_OUTPUT_BUFFER_SIZE = 1 << 16;
+
+// maps graph coordinates to output units (points): x' = (x - x_min) * scale
+struct vector_view {
+        double x_min;
+        double y_min;
+        double scale;
+        double width;
+        double height;
+};
+
+// Writes SVG and PDF files without building the document in memory.
+// Edges are emitted bucket by bucket in paths (or PDF content streams) of at most
+// MAX_SEGMENTS_PER_STROKE segments through a fixed size buffer. The edges of a bucket
+// are visited with an edge_bucket_stream, so no per edge array is built either.
+class vector_graphics_writer {
+public:
+        vector_graphics_writer();
+        virtual ~vector_graphics_writer();
+
+        // coordinates are written with at most precision decimal places, if quantization > 0
+        // they are additionally rounded to multiples of quantization (segments that collapse are dropped)
+        void set_number_format( int precision, double quantization );
+
+        // false if the file could not be written completely
+        bool write_svg( std::string filename, graph_access & G, const vector_view & view, double line_width,
+                        const edge_bucket_stream & buckets );
+
+        bool write_pdf( std::string filename, graph_access & G, const vector_view & view, double line_width,
+                        const edge_bucket_stream & buckets );
+
+private:
+        bool open( std::string & filename );
+        // false if a write or closing the file failed since open
+        bool close();
+        void flush();
+
+        void begin_content_stream( std::vector< long > & object_offset, std::vector< int > & content_objects );
+        void end_content_stream( std::vector< long > & object_offset, std::vector< int > & content_objects );
+
+        inline void append( const char * text );
+        inline void append_number( double value );
+        inline double quantize( double value );
+
+        // current position in the output file
+        long offset() { return m_written + m_fill; }
+
+        FILE *              m_file;
+        std::vector< char > m_buffer;
+        size_t              m_fill;
+        long                m_written;
+        long                m_stream_start;
+        bool                m_failed;
+
+        int       m_precision;
+        long long m_precision_factor;
+        double    m_quantization;
+};
+
+inline void vector_graphics_writer::append( const char * text ) {
+        for( ; *text != 0; text++) {
+                if( m_fill == m_buffer.size() ) flush();
+                m_buffer[m_fill++] = *text;
+        }
+}
+
+inline double vector_graphics_writer::quantize( double value ) {
+        if( m_quantization > 0 ) {
+                return floor(value / m_quantization + 0.5) * m_quantization;
+        }
+        return value;
+}
+
+inline void vector_graphics_writer::append_number( double value ) {
+        // longest number: sign, 19 digits, point and the fraction
+        if( m_fill + 48 > m_buffer.size() ) flush();
+
+        long long fixed = llround( quantize(value) * m_precision_factor );
+        if( fixed < 0 ) {
+                m_buffer[m_fill++] = '-';
+                fixed = -fixed;
+        }
+
+        long long integer  = fixed / m_precision_factor;
+        long long fraction = fixed % m_precision_factor;
+
+        char digits[24];
+        int num_digits = 0;
+        do {
+                digits[num_digits++] = '0' + integer % 10;
+                integer /= 10;
+        } while( integer > 0 );
+        while( num_digits > 0 ) m_buffer[m_fill++] = digits[--num_digits];
+
+        if( fraction > 0 ) {
+                // trailing zeros of the fraction are dropped
+                int places = m_precision;
+                while( fraction % 10 == 0 ) {
+                        fraction /= 10;
+                        places--;
+                }
+                m_buffer[m_fill++] = '.';
+                for( int i = places - 1; i >= 0; i--) {
+                        m_buffer[m_fill + i] = '0' + fraction % 10;
+                        fraction /= 10;
+                }
+                m_fill += places;
+        }
+}
+
+
+#endif /* end of include guard: VECTOR_GRAPHICS_WRITER_K4PZ7RYA */
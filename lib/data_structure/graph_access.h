@@ -125,6 +125,27 @@ private:
         return node++;
     }
 
+    // construction from known offsets, nodes and edges can be set in any order (and in parallel)
+    void set_first_edge(NodeID source, EdgeID first_edge) {
+        ASSERT_TRUE(m_building_graph);
+        m_nodes[source].firstEdge = first_edge;
+    }
+
+    void set_edge_target(EdgeID edge, NodeID target) {
+        ASSERT_TRUE(m_building_graph);
+        m_edges[edge].target = target;
+    }
+
+    void finish_parallel_construction() {
+        node = m_nodes.size()-1;
+        e    = m_edges.size();
+        m_last_source = node-1;
+        m_nodes[node].firstEdge = e;
+        m_other_node_props.resize(node+1);
+
+        m_building_graph = false;
+    }
+
     void finish_construction() {
         // inert dummy node
         m_nodes.resize(node+1);
@@ -192,6 +213,13 @@ class graph_access {
                 EdgeID new_edge(NodeID source, NodeID target);
                 void finish_construction();
 
+                // alternative to new_node / new_edge when all offsets are known in advance, e.g. from
+                // a prefix sum over the degrees. start_construction(nodes, edges) has to be called with
+                // the exact numbers, then every node and edge has to be set exactly once.
+                void setFirstEdge(NodeID node, EdgeID first_edge);
+                void setEdgeTarget(EdgeID edge, NodeID target);
+                void finish_parallel_construction();
+
                 /* ============================================================= */
                 /* graph access methods */
                 /* ============================================================= */
@@ -262,6 +290,18 @@ inline void graph_access::finish_construction() {
         graphref->finish_construction();
 }
 
+inline void graph_access::setFirstEdge(NodeID node, EdgeID first_edge) {
+        graphref->set_first_edge(node, first_edge);
+}
+
+inline void graph_access::setEdgeTarget(EdgeID edge, NodeID target) {
+        graphref->set_edge_target(edge, target);
+}
+
+inline void graph_access::finish_parallel_construction() {
+        graphref->finish_parallel_construction();
+}
+
 /* graph access methods */
 inline NodeID graph_access::number_of_nodes() {
         return graphref->number_of_nodes();
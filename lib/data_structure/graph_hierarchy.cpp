@@ -20,6 +20,8 @@
  *****************************************************************************/
 
 
+#include <algorithm>
+
 #include "graph_hierarchy.h"
 #include "tools/random_functions.h"
 
@@ -103,9 +105,30 @@ graph_access* graph_hierarchy::pop_finer_and_project() {
         m_current_coarser_graph = finer;
         m_current_level--;
 
+        if(config.release_coarse_levels) {
+                // the optimization of this level still needs the level directly above
+                // or the one faster drawing skips to
+                int needed_levels = config.faster_drawing ? std::max(1, config.faster_drawing_num_levels) : 1;
+                release_levels_above(m_current_level + needed_levels);
+        }
+
         return finer;                
 }
 
+void graph_hierarchy::release_levels_above(int level) {
+        for( int i = std::max(level + 1, 1); i < (int)m_full_graph_hierarchy.size(); i++) {
+                if(m_full_graph_hierarchy[i] != NULL) {
+                        delete m_full_graph_hierarchy[i];
+                        m_full_graph_hierarchy[i] = NULL;
+                }
+                if(m_full_mappings[i] != NULL) {
+                        delete m_full_mappings[i];
+                        m_full_mappings[i]      = NULL;
+                        m_to_delete_mappings[i] = NULL;
+                }
+        }
+}
+
 CoarseMapping * graph_hierarchy::get_mapping_of_current_finer() {
         return m_current_coarse_mapping; 
 }
@@ -182,3 +205,39 @@ bool graph_hierarchy::isEmpty( ) {
 unsigned int graph_hierarchy::size() {
         return m_the_graph_hierarchy.size();        
 }
+
+unsigned int graph_hierarchy::number_of_levels() {
+        return m_full_graph_hierarchy.size();
+}
+
+graph_access * graph_hierarchy::get_level(unsigned int level) {
+        return m_full_graph_hierarchy[level];
+}
+
+CoarseMapping * graph_hierarchy::get_level_mapping(unsigned int level) {
+        return m_full_mappings[level];
+}
+
+void graph_hierarchy::compute_centroid_coordinates() {
+        for( unsigned level = 1; level < m_full_graph_hierarchy.size(); level++) {
+                graph_access & finer   = *m_full_graph_hierarchy[level-1];
+                graph_access & coarser = *m_full_graph_hierarchy[level];
+                CoarseMapping & coarse_mapping = *m_full_mappings[level-1];
+
+                std::vector< double > x(coarser.number_of_nodes(), 0);
+                std::vector< double > y(coarser.number_of_nodes(), 0);
+                std::vector< double > weight(coarser.number_of_nodes(), 0);
+                forall_nodes(finer, node) {
+                        NodeID coarse_node = coarse_mapping[node];
+                        x[coarse_node]      += finer.getNodeWeight(node) * finer.getX(node);
+                        y[coarse_node]      += finer.getNodeWeight(node) * finer.getY(node);
+                        weight[coarse_node] += finer.getNodeWeight(node);
+                } endfor
+
+                forall_nodes_parallel(coarser, node) {
+                        if( weight[node] > 0 ) {
+                                coarser.setCoords(node, x[node] / weight[node], y[node] / weight[node]);
+                        }
+                } endfor
+        }
+}
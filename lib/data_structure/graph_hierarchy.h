@@ -43,10 +43,23 @@ public:
                
         bool isEmpty();
         unsigned int size();
+
+        // access to all levels, level 0 is the input graph and get_level_mapping(i)
+        // maps the nodes of level i to level i+1 (NULL for the coarsest level)
+        unsigned int number_of_levels();
+        graph_access  * get_level(unsigned int level);
+        CoarseMapping * get_level_mapping(unsigned int level);
+
+        // places every coarse node at the weighted centroid of the input nodes it represents
+        void compute_centroid_coordinates();
 private:
         //private functions
         graph_access * pop_coarsest();
 
+        // deletes the graphs and mappings of all levels coarser than level, they are
+        // not needed anymore once the uncoarsening has passed them
+        void release_levels_above(int level);
+
         std::stack<graph_access*>   m_the_graph_hierarchy;
         std::vector<graph_access*>  m_full_graph_hierarchy;
         std::stack<CoarseMapping*>  m_the_mappings;
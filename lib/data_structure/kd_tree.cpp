@@ -0,0 +1,173 @@
+/******************************************************************************
+ * kd_tree.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <math.h>
+
+#include "kd_tree.h"
+
+// subtrees with fewer points are built by the thread of their parent
+const NodeID KD_TREE_PARALLEL_SIZE = 1 << 15;
+
+struct compare_coordinate {
+        compare_coordinate( const std::vector< double > & x ) : x(x) {}
+        bool operator()( NodeID lhs, NodeID rhs ) const { return x[lhs] < x[rhs]; }
+        const std::vector< double > & x;
+};
+
+kd_tree::kd_tree() {
+
+}
+
+kd_tree::~kd_tree() {
+
+}
+
+void kd_tree::build( graph_access & G, NodeID leaf_size ) {
+        m_leaf_size = std::max((NodeID)1, leaf_size);
+        m_nodes.clear();
+        m_points.resize(G.number_of_nodes());
+        m_x.resize(G.number_of_nodes());
+        m_y.resize(G.number_of_nodes());
+
+        forall_nodes(G, node) {
+                m_points[node] = node;
+                m_x[node]      = G.getX(node);
+                m_y[node]      = G.getY(node);
+        } endfor
+
+        if( G.number_of_nodes() == 0 ) return;
+
+        // leaves hold at least leaf_size/2 points, so there are less than 4n/leaf_size cells.
+        // cells are claimed by an atomic counter since subtrees are built by different tasks
+        m_num_cells = 0;
+        m_nodes.resize(4 * (G.number_of_nodes() / m_leaf_size + 1));
+        #pragma omp parallel
+        {
+                #pragma omp single
+                build_subtree(0, G.number_of_nodes());
+        }
+        m_nodes.resize(m_num_cells);
+}
+
+int kd_tree::build_subtree( NodeID begin, NodeID end ) {
+        int cell = __sync_fetch_and_add(&m_num_cells, 1);
+
+        kd_tree_node current;
+        current.begin    = begin;
+        current.end      = end;
+        current.left     = -1;
+        current.right    = -1;
+        current.x_min    = current.x_max = m_x[m_points[begin]];
+        current.y_min    = current.y_max = m_y[m_points[begin]];
+        current.center_x = 0;
+        current.center_y = 0;
+        for( NodeID i = begin; i < end; i++) {
+                NodeID point      = m_points[i];
+                current.x_min     = std::min(current.x_min, m_x[point]);
+                current.x_max     = std::max(current.x_max, m_x[point]);
+                current.y_min     = std::min(current.y_min, m_y[point]);
+                current.y_max     = std::max(current.y_max, m_y[point]);
+                current.center_x += m_x[point];
+                current.center_y += m_y[point];
+        }
+        current.center_x /= end - begin;
+        current.center_y /= end - begin;
+
+        double radius_square  = 0;
+        current.second_moment = 0;
+        for( NodeID i = begin; i < end; i++) {
+                NodeID point = m_points[i];
+                double diffX = m_x[point] - current.center_x;
+                double diffY = m_y[point] - current.center_y;
+                radius_square          = std::max(radius_square, diffX*diffX+diffY*diffY);
+                current.second_moment += diffX*diffX+diffY*diffY;
+        }
+        current.radius = sqrt(radius_square);
+
+        if( end - begin > m_leaf_size ) {
+                NodeID middle = begin + (end - begin) / 2;
+                bool split_x  = current.x_max - current.x_min >= current.y_max - current.y_min;
+                std::nth_element( m_points.begin() + begin, m_points.begin() + middle, m_points.begin() + end, 
+                                  compare_coordinate(split_x ? m_x : m_y) );
+
+                // the left half is handed to another thread if it is large enough to be worth it
+                int left = -1;
+                #pragma omp task shared(left) if(middle - begin >= KD_TREE_PARALLEL_SIZE)
+                left = build_subtree(begin, middle);
+
+                current.right = build_subtree(middle, end);
+                #pragma omp taskwait
+                current.left  = left;
+        }
+
+        m_nodes[cell] = current;
+        return cell;
+}
+
+void kd_tree::k_nearest( NodeID node, unsigned k, std::vector< std::pair< double, NodeID > > & neighbors ) {
+        neighbors.clear();
+        if( k == 0 || m_nodes.empty() ) return;
+
+        // neighbors is a max-heap of the k best points found so far
+        search(root(), node, k, neighbors);
+        std::sort_heap(neighbors.begin(), neighbors.end());
+}
+
+void kd_tree::search( int cell, NodeID node, unsigned k, std::vector< std::pair< double, NodeID > > & heap ) {
+        const kd_tree_node & current = m_nodes[cell];
+        double x = m_x[node];
+        double y = m_y[node];
+
+        if( heap.size() == k ) {
+                // distance of the query point to the bounding box of the cell
+                double diffX = std::max(0.0, std::max(current.x_min - x, x - current.x_max));
+                double diffY = std::max(0.0, std::max(current.y_min - y, y - current.y_max));
+                if( diffX*diffX+diffY*diffY >= heap.front().first ) return;
+        }
+
+        if( current.left == -1 ) {
+                for( NodeID i = current.begin; i < current.end; i++) {
+                        NodeID point = m_points[i];
+                        if( point == node ) continue;
+
+                        double diffX       = m_x[point] - x;
+                        double diffY       = m_y[point] - y;
+                        double dist_square = diffX*diffX+diffY*diffY;
+                        if( heap.size() < k ) {
+                                heap.push_back(std::make_pair(dist_square, point));
+                                std::push_heap(heap.begin(), heap.end());
+                        } else if( dist_square < heap.front().first ) {
+                                std::pop_heap(heap.begin(), heap.end());
+                                heap.back() = std::make_pair(dist_square, point);
+                                std::push_heap(heap.begin(), heap.end());
+                        }
+                }
+                return;
+        }
+
+        // the child containing the query point first, it most likely shrinks the search radius
+        const kd_tree_node & left = m_nodes[current.left];
+        bool left_first = x >= left.x_min && x <= left.x_max && y >= left.y_min && y <= left.y_max;
+        search(left_first ? current.left : current.right, node, k, heap);
+        search(left_first ? current.right : current.left, node, k, heap);
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * kd_tree.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef KD_TREE_R8WQ3MZC
+#define KD_TREE_R8WQ3MZC
+
+#include <utility>
+#include <vector>
+
+#include "data_structure/graph_access.h"
+
+struct kd_tree_node {
+        // bounding box of the points of the subtree
+        double x_min;
+        double x_max;
+        double y_min;
+        double y_max;
+
+        // centroid of the points, the largest distance of a point to it 
+        // and the sum of the squared distances of the points to it
+        double center_x;
+        double center_y;
+        double radius;
+        double second_moment;
+
+        // the points of the subtree are points()[begin] ... points()[end-1]
+        NodeID begin;
+        NodeID end;
+
+        // children, -1 for leaves
+        int left;
+        int right;
+};
+
+// 2D kd-tree over the coordinates of the nodes of a graph. Cells are split at the
+// median of their longer side until they contain at most leaf_size points. Large 
+// subtrees are built in parallel.
+class kd_tree {
+public:
+        kd_tree();
+        virtual ~kd_tree();
+
+        void build( graph_access & G, NodeID leaf_size = 16 );
+
+        // the k nearest points to node (excluding node itself) as (squared distance, point) pairs
+        // sorted by distance. neighbors can be reused between the queries of a thread.
+        void k_nearest( NodeID node, unsigned k, std::vector< std::pair< double, NodeID > > & neighbors );
+
+        int root() const { return m_nodes.empty() ? -1 : 0; }
+        const kd_tree_node & node( int cell ) const { return m_nodes[cell]; }
+        const std::vector< NodeID > & points() const { return m_points; }
+
+        // coordinates of the graph nodes (indexed by node id)
+        const std::vector< double > & x() const { return m_x; }
+        const std::vector< double > & y() const { return m_y; }
+
+private:
+        int build_subtree( NodeID begin, NodeID end );
+        void search( int cell, NodeID node, unsigned k, std::vector< std::pair< double, NodeID > > & heap );
+
+        NodeID                      m_leaf_size;
+        int                         m_num_cells;
+        std::vector< kd_tree_node > m_nodes;
+        std::vector< NodeID >       m_points;
+        std::vector< double >       m_x;
+        std::vector< double >       m_y;
+};
+
+
+#endif /* end of include guard: KD_TREE_R8WQ3MZC */
@@ -99,9 +99,15 @@ typedef enum {
 typedef enum {
   GRAPHICS_TYPE_INVALID,
   GRAPHICS_TYPE_PNG,
-  GRAPHICS_TYPE_PDF
+  GRAPHICS_TYPE_PDF,
+  GRAPHICS_TYPE_SVG
 } GraphicsFormatType;
 
+typedef enum {
+        TONE_MAPPING_LOG,
+        TONE_MAPPING_HISTOGRAM
+} ToneMappingType;
+
 
 #endif
 
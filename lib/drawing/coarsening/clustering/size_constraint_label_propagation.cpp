@@ -24,6 +24,7 @@
 #include "data_structure/union_find.h"
 #include "node_ordering.h"
 #include "tools/random_functions.h"
+#include "tools/trace_recorder.h"
 #include "io/graph_io.h"
 
 #include "size_constraint_label_propagation.h"
@@ -149,6 +150,7 @@ void size_constraint_label_propagation::remap_cluster_ids(const Config & config,
                                                           std::vector<NodeWeight> & cluster_id,
                                                           NodeID & no_of_coarse_vertices, bool apply_to_graph) {
 
+        trace_scope scope("remap");
         PartitionID cur_no_clusters = 0;
         std::unordered_map<PartitionID, PartitionID> remap;
         forall_nodes(G, node) {
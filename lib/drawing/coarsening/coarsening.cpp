@@ -21,6 +21,7 @@
 
 #include <limits>
 #include <sstream>
+#include <unordered_map>
 
 #include "coarsening.h"
 #include "coarsening_configurator.h"
@@ -29,6 +30,8 @@
 #include "definitions.h"
 #include "graph_io.h"
 #include "stop_rules/stop_rules.h"
+#include "tools/memory_accounting.h"
+#include "tools/trace_recorder.h"
 
 coarsening::coarsening() {
 
@@ -57,6 +60,7 @@ void coarsening::perform_coarsening(const Config & config, graph_access & G, gra
         unsigned int level    = 0;
         bool contraction_stop = false;
         do {
+                trace_scope level_scope("coarsening level", level);
                 graph_access* coarser = new graph_access();
                 coarse_mapping        = new CoarseMapping();
                 Matching edge_matching;
@@ -67,8 +71,15 @@ void coarsening::perform_coarsening(const Config & config, graph_access & G, gra
                 copy_of_config.upper_bound_partition = std::min(pow(config.size_base,level+1), ceil(config.upper_bound_partition/copy_of_config.cluster_coarsening_factor));
                 copy_of_config.upper_bound_partition = std::min(copy_of_config.upper_bound_partition, G.number_of_nodes()-1);
 
-                edge_matcher->match(copy_of_config, *finer, edge_matching, 
-                                    *coarse_mapping, no_of_coarser_vertices, permutation);
+                if( level == 0 && config.use_input_partition ) {
+                        // the given clustering replaces label propagation on the first level
+                        trace_scope scope("input partition");
+                        input_partition_mapping(G, *coarse_mapping, no_of_coarser_vertices);
+                } else {
+                        trace_scope scope("label propagation", finer->number_of_nodes());
+                        edge_matcher->match(copy_of_config, *finer, edge_matching, 
+                                            *coarse_mapping, no_of_coarser_vertices, permutation);
+                }
 
                 if( level == 0 ) {
                         forall_nodes_parallel(G, node) {
@@ -78,14 +89,21 @@ void coarsening::perform_coarsening(const Config & config, graph_access & G, gra
                 
                 delete edge_matcher; 
 
-                contracter->contract(copy_of_config, *finer, *coarser, edge_matching, 
-                                     *coarse_mapping, no_of_coarser_vertices, permutation);
+                {
+                        trace_scope scope("contraction", no_of_coarser_vertices);
+                        contracter->set_level(level);
+                        contracter->contract(copy_of_config, *finer, *coarser, edge_matching, 
+                                             *coarse_mapping, no_of_coarser_vertices, permutation);
+                }
 
                 hierarchy.push_back(finer, coarse_mapping);
+                memory_accounting::record_graph("graph", level, *finer);
+                memory_accounting::record("coarse mapping", level, finer->number_of_nodes(), finer->number_of_edges(),
+                                          coarse_mapping->size() * sizeof(NodeID), 0, MEMORY_PERSISTENT);
                 contraction_stop = coarsening_stop_rule->stop(no_of_finer_vertices, no_of_coarser_vertices) && coarser->number_of_edges() != 0;
               
                 no_of_finer_vertices = no_of_coarser_vertices;
-                PRINT(std::cout <<  "no of coarser vertices " << no_of_coarser_vertices   
+                if(!config.quiet) PRINT(std::cout <<  "no of coarser vertices " << no_of_coarser_vertices   
                                 <<  " and no of edges " <<  coarser->number_of_edges() << std::endl;)
 
                 if( finer->number_of_nodes()/no_of_coarser_vertices < 1.1) {
@@ -101,9 +119,26 @@ void coarsening::perform_coarsening(const Config & config, graph_access & G, gra
         } while( contraction_stop ); 
 
         hierarchy.push_back(finer, NULL); // append the last created level
+        memory_accounting::record_graph("graph", level, *finer);
 
         delete contracter;
         delete coarsening_stop_rule;
 }
 
+void coarsening::input_partition_mapping(graph_access & G, CoarseMapping & coarse_mapping, NodeID & no_of_coarse_vertices) {
+        // block ids can be arbitrary (e.g. ids of a community detection), so only the distinct ids are stored
+        std::unordered_map< PartitionID, NodeID > remap;
+        coarse_mapping.resize(G.number_of_nodes());
+        no_of_coarse_vertices = 0;
+        forall_nodes(G, node) {
+                PartitionID block = G.getPartitionIndex(node);
+                std::unordered_map< PartitionID, NodeID >::iterator it = remap.find(block);
+                if( it == remap.end() ) {
+                        it = remap.insert(std::make_pair(block, no_of_coarse_vertices++)).first;
+                }
+                coarse_mapping[node] = it->second;
+        } endfor
+        G.set_partition_count(no_of_coarse_vertices);
+}
+
 
@@ -32,6 +32,10 @@ public:
         virtual ~coarsening ();
 
         void perform_coarsening(const Config & config, graph_access & G, graph_hierarchy & hierarchy);
+
+private:
+        // uses the partition indices of G as clustering, the blocks are numbered consecutively
+        void input_partition_mapping(graph_access & G, CoarseMapping & coarse_mapping, NodeID & no_of_coarse_vertices);
 };
 
 #endif /* end of include guard: COARSENING_UU97ZBTR */
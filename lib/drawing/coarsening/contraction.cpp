@@ -20,11 +20,14 @@
  *****************************************************************************/
 
 
+#include <algorithm>
+
 #include "contraction.h"
 #include "uncoarsening/complete_boundary.h"
 #include "macros_assertions.h"
+#include "tools/memory_accounting.h"
 
-contraction::contraction() {
+contraction::contraction() : m_level(0) {
 
 }
 
@@ -41,6 +44,9 @@ void contraction::contract(const Config & config,
                            const NodeID & no_of_coarse_vertices,
                            const NodePermutationMap & permutation) const {
 
+        if(config.matching_type == CLUSTER_COARSENING && config.lean_contraction) {
+                return contract_clustering_lean(config, G, coarser, coarse_mapping, no_of_coarse_vertices);
+        }
         if(config.matching_type == CLUSTER_COARSENING) {
                 return contract_clustering(config, G, coarser, edge_matching, coarse_mapping, no_of_coarse_vertices, permutation);
         }
@@ -120,6 +126,10 @@ void contraction::contract_clustering(const Config & config,
         complete_boundary bnd(&G);
         bnd.build();
         bnd.getUnderlyingQuotientGraph(coarser);
+        if( memory_accounting::enabled() ) {
+                memory_accounting::record("contraction boundary", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                          0, bnd.memory_bytes(), MEMORY_TEMPORARY);
+        }
 
         G.set_partition_count(k);
         forall_nodes(G, node) {
@@ -127,3 +137,83 @@ void contraction::contract_clustering(const Config & config,
                 coarser.setPartitionIndex(coarse_mapping[node], G.getPartitionIndex(node));
         } endfor
 }
+
+void contraction::contract_clustering_lean(const Config & config, 
+                                           graph_access & G, 
+                                           graph_access & coarser, 
+                                           const CoarseMapping & coarse_mapping,
+                                           const NodeID & no_of_coarse_vertices) const {
+
+        // nodes of every cluster in CSR format
+        std::vector< NodeID > cluster_start(no_of_coarse_vertices + 1, 0);
+        forall_nodes(G, node) {
+                cluster_start[coarse_mapping[node] + 1]++;
+        } endfor
+        for( NodeID cluster = 0; cluster < no_of_coarse_vertices; cluster++) {
+                cluster_start[cluster + 1] += cluster_start[cluster];
+        }
+
+        std::vector< NodeID > cluster_nodes(G.number_of_nodes());
+        {
+                std::vector< NodeID > insert_pos(cluster_start.begin(), cluster_start.end() - 1);
+                forall_nodes(G, node) {
+                        cluster_nodes[insert_pos[coarse_mapping[node]]++] = node;
+                } endfor
+        }
+
+        // the first pass counts the coarse edges so that the coarser graph is allocated with its
+        // exact size, the second one creates them. edge_positions marks the neighbors of the 
+        // current cluster, in the first pass with the cluster itself
+        std::vector< EdgeID > edge_positions(no_of_coarse_vertices, UNDEFINED_EDGE);
+        EdgeID no_of_coarse_edges = 0;
+        for( NodeID cluster = 0; cluster < no_of_coarse_vertices; cluster++) {
+                for( NodeID i = cluster_start[cluster]; i < cluster_start[cluster + 1]; i++) {
+                        NodeID node = cluster_nodes[i];
+                        forall_out_edges(G, e, node) {
+                                NodeID target_cluster = coarse_mapping[G.getEdgeTarget(e)];
+                                if( target_cluster == cluster || edge_positions[target_cluster] == cluster ) continue;
+
+                                edge_positions[target_cluster] = cluster;
+                                no_of_coarse_edges++;
+                        } endfor
+                }
+        }
+
+        std::fill(edge_positions.begin(), edge_positions.end(), UNDEFINED_EDGE);
+        coarser.start_construction(no_of_coarse_vertices, no_of_coarse_edges);
+        for( NodeID cluster = 0; cluster < no_of_coarse_vertices; cluster++) {
+                NodeID coarse_node = coarser.new_node();
+                NodeWeight weight  = 0;
+                for( NodeID i = cluster_start[cluster]; i < cluster_start[cluster + 1]; i++) {
+                        NodeID node = cluster_nodes[i];
+                        weight += G.getNodeWeight(node);
+
+                        forall_out_edges(G, e, node) {
+                                NodeID target_cluster = coarse_mapping[G.getEdgeTarget(e)];
+                                if( target_cluster == cluster ) continue;
+
+                                if( edge_positions[target_cluster] == UNDEFINED_EDGE ) {
+                                        EdgeID coarse_edge = coarser.new_edge(coarse_node, target_cluster);
+                                        coarser.setEdgeWeight(coarse_edge, G.getEdgeWeight(e));
+                                        edge_positions[target_cluster] = coarse_edge;
+                                } else {
+                                        EdgeID coarse_edge = edge_positions[target_cluster];
+                                        coarser.setEdgeWeight(coarse_edge, coarser.getEdgeWeight(coarse_edge) + G.getEdgeWeight(e));
+                                }
+                        } endfor
+                }
+                coarser.setNodeWeight(coarse_node, weight);
+
+                forall_out_edges(coarser, e, coarse_node) {
+                       edge_positions[coarser.getEdgeTarget(e)] = UNDEFINED_EDGE;
+                } endfor
+        }
+        coarser.finish_construction();
+        memory_accounting::record("contraction arrays", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  (cluster_start.size() + cluster_nodes.size()) * sizeof(NodeID) + edge_positions.size() * sizeof(EdgeID), 
+                                  0, MEMORY_TEMPORARY);
+
+        forall_nodes(G, node) {
+                coarser.setPartitionIndex(coarse_mapping[node], G.getPartitionIndex(node));
+        } endfor
+}
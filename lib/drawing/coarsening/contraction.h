@@ -49,7 +49,16 @@ class contraction {
                               const NodeID & no_of_coarse_vertices,
                               const NodePermutationMap & permutation) const;
 
+                // same result as contract_clustering up to the order of the edges, but instead of
+                // the hash tables of a complete boundary only arrays of size n + m are used
+                void contract_clustering_lean(const Config & config, 
+                              graph_access & finer, 
+                              graph_access & coarser, 
+                              const CoarseMapping & coarse_mapping,
+                              const NodeID & no_of_coarse_vertices) const;
 
+                // level of the finer graph in the hierarchy, used for memory accounting
+                void set_level( int level ) { m_level = level; }
                  
         private:
                 // visits an edge in G (and auxillary graph) and updates/creates and edge in coarser graph 
@@ -60,7 +69,7 @@ class contraction {
                                 const EdgeID e,
                                 const std::vector<NodeID> & new_edge_targets) const;
 
-
+                int m_level;
 };
 
 inline void contraction::visit_edge(graph_access & G, 
@@ -0,0 +1,228 @@
+/******************************************************************************
+ * component_drawer.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <math.h>
+
+#include "component_drawer.h"
+#include "graph_drawer.h"
+#include "tools/connected_components.h"
+#include "tools/graph_extractor.h"
+#include "tools/random_functions.h"
+#include "tools/timer.h"
+#include "tools/trace_recorder.h"
+
+static bool compare_box_height( const component_box & lhs, const component_box & rhs ) {
+        return lhs.height > rhs.height || (lhs.height == rhs.height && lhs.component < rhs.component);
+}
+
+component_drawer::component_drawer() {
+
+}
+
+component_drawer::~component_drawer() {
+
+}
+
+void component_drawer::draw_all_components( Config & config, graph_access & G ) {
+        timer t;
+        std::vector< NodeID > component;
+        std::vector< NodeID > sizes;
+        connected_components cc;
+        NodeID k = 0;
+        {
+                trace_scope scope("connected components");
+                k = cc.compute_components(G, component, sizes);
+        }
+
+        long n = G.number_of_nodes();
+        std::vector< PartitionID > input_partition;
+        if( config.use_input_partition ) {
+                input_partition.resize(n);
+        }
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                if( config.use_input_partition ) input_partition[node] = G.getPartitionIndex(node);
+                G.setPartitionIndex(node, component[node]);
+        }
+        G.set_partition_count(k);
+
+        std::vector< graph_access > subgraphs;
+        std::vector< std::vector< NodeID > > mapping;
+        graph_extractor E;
+        {
+                trace_scope scope("extract components", k);
+                E.extract_all_blocks(G, subgraphs, mapping);
+        }
+        if( config.use_input_partition ) {
+                #pragma omp parallel for schedule(dynamic, 1)
+                for( long c = 0; c < (long)k; c++) {
+                        forall_nodes(subgraphs[c], node) {
+                                subgraphs[c].setPartitionIndex(node, input_partition[mapping[c][node]]);
+                        } endfor
+                }
+        }
+
+        // components are drawn by decreasing size, the largest one with the seed of a normal run
+        std::vector< NodeID > order(k);
+        for( NodeID c = 0; c < k; c++) {
+                order[c] = c;
+        }
+        std::stable_sort( order.begin(), order.end(), [&sizes]( NodeID lhs, NodeID rhs ) { return sizes[lhs] > sizes[rhs]; } );
+        std::cout <<  "drawing " << k << " components, the largest has " << (k > 0 ? sizes[order[0]] : 0) 
+                  <<  " nodes (" << t.elapsed() << "s for extraction)" << std::endl;
+
+        NodeID num_large = 0;
+        while( num_large < k && sizes[order[num_large]] >= INNER_PARALLEL_COMPONENT_SIZE ) {
+                draw_component(config, subgraphs[order[num_large]], num_large);
+                num_large++;
+        }
+
+        // nested parallel regions of the drawer run with a single thread here, their log is suppressed
+        t.restart();
+        Config quiet_config = config;
+        quiet_config.quiet  = true;
+        #pragma omp parallel for schedule(dynamic, 1)
+        for( long rank = num_large; rank < (long)k; rank++) {
+                draw_component(quiet_config, subgraphs[order[rank]], rank);
+        }
+        std::cout <<  "drew " << k - num_large << " small components in " << t.elapsed() << std::endl;
+
+        // the average edge length of the real drawings separates the components 
+        double length_sum = 0;
+        double num_edges  = 0;
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:length_sum,num_edges)
+        for( long c = 0; c < (long)k; c++) {
+                graph_access & C = subgraphs[c];
+                if( C.number_of_nodes() <= 2 ) continue;
+                forall_nodes(C, node) {
+                        forall_out_edges(C, e, node) {
+                                NodeID target = C.getEdgeTarget(e);
+                                double dx = C.getX(node) - C.getX(target);
+                                double dy = C.getY(node) - C.getY(target);
+                                length_sum += sqrt(dx*dx + dy*dy);
+                                num_edges++;
+                        } endfor
+                } endfor
+        }
+        double margin = num_edges > 0 && length_sum > 0 ? length_sum / num_edges : 1;
+
+        trace_scope scope("pack components");
+        std::vector< component_box > boxes(k);
+        for( NodeID c = 0; c < k; c++) {
+                if( subgraphs[c].number_of_nodes() == 2 ) {
+                        subgraphs[c].setCoords(1, margin, 0);
+                }
+                bounding_box(subgraphs[c], margin, boxes[c]);
+                boxes[c].component = c;
+        }
+        pack_boxes(boxes);
+
+        // the clusterings of the components are numbered consecutively
+        std::vector< PartitionID > cluster_offset(k + 1, 0);
+        for( NodeID c = 0; c < k; c++) {
+                PartitionID num_clusters = 0;
+                forall_nodes(subgraphs[c], node) {
+                        num_clusters = std::max(num_clusters, subgraphs[c].getPartitionIndex(node) + 1);
+                } endfor
+                cluster_offset[c + 1] = cluster_offset[c] + num_clusters;
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for( long i = 0; i < (long)k; i++) {
+                component_box & box = boxes[i];
+                graph_access  & C   = subgraphs[box.component];
+                forall_nodes(C, node) {
+                        NodeID original = mapping[box.component][node];
+                        G.setCoords(original, box.x + C.getX(node) - box.x_min, box.y + C.getY(node) - box.y_min);
+                        G.setPartitionIndex(original, cluster_offset[box.component] + C.getPartitionIndex(node));
+                } endfor
+        }
+        G.set_partition_count(cluster_offset[k]);
+}
+
+void component_drawer::draw_component( Config & config, graph_access & C, NodeID rank ) {
+        // an input partition is renumbered by the coarsening of the drawer
+        bool keep_partition = config.use_input_partition && C.number_of_nodes() > 2;
+        C.set_partition_count(1);
+        forall_nodes(C, node) {
+                if( !keep_partition ) C.setPartitionIndex(node, 0);
+                C.setCoords(node, 0, 0);
+        } endfor
+        // the second node of a single edge is placed once the edge length is known
+        if( C.number_of_nodes() <= 2 ) return;
+
+        trace_scope scope("component", C.number_of_nodes());
+        Config cfg = config;
+        cfg.faster_drawing_num_levels = graph_drawer::faster_drawing_levels(C.number_of_nodes());
+        cfg.upper_bound_partition     = C.number_of_nodes()-1;
+        cfg.write_previews            = false;
+        cfg.write_hierarchy           = false;
+
+        random_functions::setSeed(config.seed + rank);
+        graph_drawer gd;
+        gd.perform_drawing(cfg, C);
+}
+
+void component_drawer::bounding_box( graph_access & C, double margin, component_box & box ) {
+        double x_max = C.getX(0);
+        double y_max = C.getY(0);
+        box.x_min = x_max;
+        box.y_min = y_max;
+        forall_nodes(C, node) {
+                box.x_min = std::min(box.x_min, C.getX(node));
+                box.y_min = std::min(box.y_min, C.getY(node));
+                x_max     = std::max(x_max, C.getX(node));
+                y_max     = std::max(y_max, C.getY(node));
+        } endfor
+        box.width  = x_max - box.x_min + margin;
+        box.height = y_max - box.y_min + margin;
+        box.x      = 0;
+        box.y      = 0;
+}
+
+void component_drawer::pack_boxes( std::vector< component_box > & boxes ) {
+        double area      = 0;
+        double max_width = 0;
+        for( unsigned i = 0; i < boxes.size(); i++) {
+                area     += boxes[i].width * boxes[i].height;
+                max_width = std::max(max_width, boxes[i].width);
+        }
+        double strip_width = std::max(max_width, sqrt(area));
+
+        std::sort( boxes.begin(), boxes.end(), compare_box_height );
+
+        double x = 0;
+        double y = 0;
+        double shelf_height = 0;
+        for( unsigned i = 0; i < boxes.size(); i++) {
+                if( x > 0 && x + boxes[i].width > strip_width ) {
+                        y += shelf_height;
+                        x  = 0;
+                        shelf_height = 0;
+                }
+                boxes[i].x = x;
+                boxes[i].y = y;
+                x += boxes[i].width;
+                shelf_height = std::max(shelf_height, boxes[i].height);
+        }
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * component_drawer.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef COMPONENT_DRAWER_H7KQ2XVM
+#define COMPONENT_DRAWER_H7KQ2XVM
+
+#include <vector>
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+
+// components with at least this many nodes are drawn one after another using all threads,
+// smaller components are drawn concurrently with one thread each
+const NodeID INNER_PARALLEL_COMPONENT_SIZE = 50000;
+
+// axis parallel bounding box of a drawn component, (x, y) is its position in the packing
+struct component_box {
+        NodeID component;
+        double x_min;
+        double y_min;
+        double width;
+        double height;
+        double x;
+        double y;
+};
+
+// Draws every connected component of a graph on its own and packs the drawings into one.
+// Large components use the parallel multilevel drawer, small ones are taken from a work queue.
+// The bounding boxes are then packed into shelves of a strip that is about as wide as the
+// square root of the total area (tallest boxes first), so that the drawing is roughly square.
+class component_drawer {
+public:
+        component_drawer();
+        virtual ~component_drawer();
+
+        // sets the coordinates of all nodes of G. the partition indices of G are set to the
+        // clustering of the first level like for a drawing of a connected graph.
+        void draw_all_components( Config & config, graph_access & G );
+
+private:
+        void draw_component( Config & config, graph_access & C, NodeID rank );
+        void bounding_box( graph_access & C, double margin, component_box & box );
+        void pack_boxes( std::vector< component_box > & boxes );
+};
+
+
+#endif /* end of include guard: COMPONENT_DRAWER_H7KQ2XVM */
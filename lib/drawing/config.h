@@ -120,6 +120,12 @@ struct Config
 
         bool compute_MEnt;
 
+        bool compute_crossings;
+
+        unsigned crossing_samples;
+
+        bool compute_neighborhood_preservation;
+
         bool light_intercluster_edges;
 
         bool print_final_distances;
@@ -150,6 +156,85 @@ struct Config
 
         double linewidth;
 
+        int image_max_dim_px;
+
+        bool tiled_rasterizer;
+
+        bool additive_blending;
+
+        bool density_rendering;
+
+        bool density_of_nodes;
+
+        ToneMappingType tone_mapping;
+
+        bool tile_pyramid;
+
+        std::string tile_directory;
+
+        int tile_max_zoom;
+
+        int tile_coarse_zoom;
+
+        bool stream_vector_output;
+
+        int vector_precision;
+
+        double vector_quantization;
+
+        int edge_length_quantiles;
+
+        int png_compression_level;
+
+        bool write_previews;
+
+        std::string preview_prefix;
+
+        bool preview_coordinates;
+
+        bool preview_density;
+
+        bool write_hierarchy;
+
+        std::string hierarchy_filename;
+
+        // suppresses the log of the drawer, set for drawings that run concurrently
+        bool quiet;
+
+        unsigned sampled_stress_threshold;
+
+        double stress_target_error;
+
+        bool sampled_coordinate_scaling;
+
+        unsigned maxent_exact_threshold;
+
+        double maxent_theta;
+
+        std::string report_filename;
+
+        bool draw_all_components;
+
+        bool use_input_partition;
+
+        std::string input_partition_filename;
+
+        std::string trace_filename;
+
+        bool perf_counters;
+
+        bool memory_report;
+
+        double memory_budget;
+
+        bool release_coarse_levels;
+
+        bool lean_contraction;
+
+        bool sampled_edge_length_colors;
+
+        int metric_threads;
+
 
         void LogDump(FILE *out) const {
         }
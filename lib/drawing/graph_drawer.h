@@ -26,9 +26,12 @@
 #include "uncoarsening/uncoarsening.h"
 #include "data_structure/graph_access.h"
 #include "config.h"
+#include "graph_io.h"
 #include "tools/random_functions.h"
+#include "tools/memory_accounting.h"
 #include "tools/quality_metrics.h"
 #include "tools/timer.h"
+#include "tools/trace_recorder.h"
 #include "uncoarsening/local_optimizer.h"
 
  
@@ -37,6 +40,35 @@ public:
         graph_drawer();
         virtual ~graph_drawer();
 
+        // number of levels that are skipped by the faster drawing algorithm on a graph with n nodes
+        static int faster_drawing_levels( NodeID n ) {
+                if( n < 100) {
+                        return 3;
+                } else if ( n < 1000) {
+                        return 5;
+                } else if ( n < 10000) {
+                        return 6;
+                } else if ( n < 100000) {
+                        return 7;
+                } else if ( n < 300000) {
+                        return 8;
+                } else if ( n < 600000) {
+                        return 9;
+                } else if ( n < 2000000) {
+                        return 10;
+                } else if ( n < 4000000) {
+                        return 11;
+                } else if ( n < 10000000) {
+                        return 12;
+                } else if ( n < 20000000) {
+                        return 15;
+                } else if ( n < 40000000) {
+                        return 17;
+                } else {
+                        return 20;
+                }
+        }
+
         void perform_drawing( Config & config, graph_access & G) {
                 coarsening coarsen;
                 uncoarsening uncoarsen;
@@ -45,8 +77,12 @@ public:
                 timer t;
 
                 t.restart();
-                coarsen.perform_coarsening(config, G, hierarchy);
-                std::cout <<  "coarsening took " <<  t.elapsed() << std::endl;
+                {
+                        trace_scope scope("coarsening", G.number_of_nodes());
+                        coarsen.perform_coarsening(config, G, hierarchy);
+                }
+                memory_accounting::record_phase("coarsening");
+                if(!config.quiet) std::cout <<  "coarsening took " <<  t.elapsed() << std::endl;
 
                 graph_access& Q = *hierarchy.get_coarsest();
                 if(Q.number_of_nodes() > 2 || Q.number_of_nodes() < 2) {
@@ -61,10 +97,30 @@ public:
                         dist /= config.general_distance_scaling_factor;
 
                         Q.setCoords(1, 0, dist);
-                        std::cout <<  "current setting to distance " <<  dist  << std::endl;
+                        if(!config.quiet) std::cout <<  "current setting to distance " <<  dist  << std::endl;
                 }
                 
-                uncoarsen.perform_uncoarsening(config, hierarchy);
+                {
+                        trace_scope scope("uncoarsening", G.number_of_nodes());
+                        uncoarsen.perform_uncoarsening(config, hierarchy);
+                }
+                memory_accounting::record_phase("uncoarsening");
+
+                if(config.write_hierarchy) {
+                        trace_scope scope("write hierarchy");
+                        hierarchy.compute_centroid_coordinates();
+
+                        std::vector< graph_access* > levels;
+                        std::vector< CoarseMapping* > mappings;
+                        for( unsigned level = 0; level < hierarchy.number_of_levels(); level++) {
+                                levels.push_back(hierarchy.get_level(level));
+                                mappings.push_back(hierarchy.get_level_mapping(level));
+                        }
+                        std::cout <<  "writing " << levels.size() << " levels to " << config.hierarchy_filename << std::endl;
+                        if(graph_io::writeHierarchy(levels, mappings, config.hierarchy_filename)) {
+                                std::cerr <<  "Error: the hierarchy could not be written to " << config.hierarchy_filename << std::endl;
+                        }
+                }
         };
 };
 
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * memory_planner.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <omp.h>
+
+#include "algorithms/shortest_paths.h"
+#include "burn_drawing/burn_drawing.h"
+#include "burn_drawing/tile_pyramid.h"
+#include "burn_drawing/tiled_rasterizer.h"
+#include "memory_planner.h"
+#include "tools/memory_accounting.h"
+
+memory_planner::memory_planner() {
+
+}
+
+memory_planner::~memory_planner() {
+
+}
+
+bool memory_planner::plan( Config & config, NodeID n, EdgeID m ) {
+        double budget = config.memory_budget * 1024 * 1024;
+
+        // all levels are needed to write the hierarchy
+        config.release_coarse_levels = !config.write_hierarchy;
+        config.lean_contraction      = true;
+
+        int metric_threads = omp_get_max_threads();
+        memory_estimate est = estimate( config, n, m, metric_threads );
+
+        if( est.rendering > budget && !config.draw_initial_clustering && !config.sampled_edge_length_colors ) {
+                config.sampled_edge_length_colors = true;
+                est = estimate( config, n, m, metric_threads );
+        }
+        if( est.rendering > budget && config.export_grafic_type == GRAPHICS_TYPE_PNG 
+         && !config.tile_pyramid && !config.density_rendering ) {
+                // the density image is twice as large as the image of the edge renderers
+                config.density_rendering = true;
+                memory_estimate density = estimate( config, n, m, metric_threads );
+                if( density.rendering < est.rendering ) {
+                        est = density;
+                } else {
+                        config.density_rendering = false;
+                }
+        }
+        while( est.metrics > budget && metric_threads > 1 ) {
+                metric_threads--;
+                est = estimate( config, n, m, metric_threads );
+        }
+        config.metric_threads = metric_threads;
+
+        print_estimate( est );
+
+        double peak = std::max(est.drawing, std::max(est.rendering, est.metrics));
+        if( peak > budget ) {
+                std::cerr <<  "Error: memory budget of " << config.memory_budget << " MB is too small for a graph with " 
+                          <<  n << " nodes and " << m << " edges, the leanest choice needs about " 
+                          <<  std::fixed << std::setprecision(0) << peak / (1024 * 1024) << " MB (baseline " 
+                          <<  est.baseline / (1024 * 1024) << " MB, drawing " << est.drawing / (1024 * 1024) 
+                          <<  " MB, rendering " << est.rendering / (1024 * 1024) << " MB, metrics " 
+                          <<  est.metrics / (1024 * 1024) << " MB)" << std::endl;
+                return false;
+        }
+
+        std::cout <<  "memory plan: release coarse levels " << (config.release_coarse_levels ? "yes" : "no") 
+                  <<  ", lean contraction yes"
+                  <<  ", sampled edge length colors " << (config.sampled_edge_length_colors ? "yes" : "no") 
+                  <<  ", density rendering " << (config.density_rendering ? "yes" : "no") 
+                  <<  ", metric threads " << config.metric_threads << std::endl;
+        return true;
+}
+
+memory_estimate memory_planner::estimate( const Config & config, NodeID n, EdgeID m, int metric_threads ) {
+        memory_estimate est;
+        est.baseline  = memory_accounting::current_rss();
+        est.drawing   = est.baseline + drawing_bytes( config, n, m );
+        est.rendering = est.baseline;
+        est.metrics   = est.baseline;
+
+        // the input graph and the copy of the largest component stay until the end
+        double graphs = graph_bytes(n, m);
+        if( !config.draw_all_components ) {
+                graphs += graph_bytes(n, m) + sizeof(NodeID) * (double)n;
+        }
+
+        if( config.burn_image_to_disk ) {
+                est.rendering += graphs + rendering_bytes( config, n, m );
+        }
+        if( config.compute_FSM || config.compute_MEnt || config.burn_coordinates_to_disk ) {
+                est.metrics += graphs + metrics_bytes( n, metric_threads );
+        }
+        return est;
+}
+
+double memory_planner::graph_bytes( double n, double m ) {
+        double node_bytes = sizeof(Node) + sizeof(refinementNode) + sizeof(otherNodeProp);
+        double edge_bytes = sizeof(Edge) + sizeof(otherEdgeProp);
+        return (n + 1) * node_bytes + 2 * m * edge_bytes;
+}
+
+double memory_planner::drawing_bytes( const Config & config, double n, double m ) {
+        double input = graph_bytes(n, m);
+        if( !config.draw_all_components ) {
+                input += graph_bytes(n, m) + sizeof(NodeID) * n;
+        }
+
+        // the coarse levels together are at most as large as the finest level, every level has a mapping
+        double hierarchy = graph_bytes(n, m) + 2 * sizeof(NodeID) * n;
+
+        // label propagation arrays and either the CSR arrays or the boundary hash tables of the contraction
+        double coarsening = 4 * sizeof(NodeID) * n;
+        if( config.lean_contraction ) {
+                coarsening += 4 * sizeof(NodeID) * n;
+        } else {
+                coarsening += BOUNDARY_BYTES_PER_EDGE * 2 * m;
+        }
+
+        // new coordinates, distances per edge, cluster membership and the projected coordinates
+        double uncoarsening = 2 * sizeof(CoordType) * n + sizeof(float) * 2 * m + 4 * sizeof(NodeID) * n;
+
+        return input + hierarchy + std::max(coarsening, uncoarsening);
+}
+
+double memory_planner::rendering_bytes( const Config & config, double n, double m ) {
+        double pixels = (double)config.image_max_dim_px * config.image_max_dim_px;
+        bool   png    = config.export_grafic_type == GRAPHICS_TYPE_PNG;
+
+        if( png && config.density_rendering && !config.tile_pyramid ) {
+                // density per pixel and the image
+                return pixels * (sizeof(float) + sizeof(uint32_t));
+        }
+
+        bool stream = !config.tile_pyramid && (config.export_grafic_type == GRAPHICS_TYPE_SVG 
+                   || (config.export_grafic_type == GRAPHICS_TYPE_PDF && config.stream_vector_output));
+        if( stream ) {
+                // first edge per node and the sampled lengths or the nodes sorted by cluster
+                return sizeof(EdgeID) * n + std::max(sizeof(double) * std::min(m, (double)EDGE_LENGTH_SAMPLE_SIZE), 
+                                                     2 * sizeof(NodeID) * n);
+        }
+
+        // first edge per node, bucket per edge and the edges sorted by bucket
+        double buckets = sizeof(EdgeID) * n + (sizeof(unsigned) + sizeof(source_target_pair)) * m;
+        if( !config.draw_initial_clustering ) {
+                double lengths = m;
+                if( config.sampled_edge_length_colors && m > EDGE_LENGTH_SAMPLE_SIZE ) {
+                        lengths = EDGE_LENGTH_SAMPLE_SIZE;
+                }
+                buckets += sizeof(double) * lengths;
+        }
+
+        if( config.tile_pyramid ) {
+                // (tile, edge) pairs plus id and start of every non empty tile. the n nodes are spread 
+                // over the square of a level, so an edge is about tiles_per_side / sqrt(n) tiles long 
+                // and touches twice as many tiles (rows and columns). levels deeper than TILE_REGION_ZOOM 
+                // hold the pairs of the regions and of one region at a time, estimated by the average region
+                int    binned_zoom    = std::min(config.tile_max_zoom, TILE_REGION_ZOOM);
+                double tiles_per_side = pow(2.0, binned_zoom);
+                double entries        = m * (1 + 2 * tiles_per_side / sqrt(std::max(1.0, n)));
+                double tiles          = std::min(entries, tiles_per_side * tiles_per_side);
+                double bytes          = sizeof(tile_entry) * entries + (sizeof(TileID) + sizeof(size_t)) * tiles;
+                if( config.tile_max_zoom > TILE_REGION_ZOOM ) {
+                        double deep_tiles_per_side = pow(2.0, config.tile_max_zoom);
+                        double deep_entries        = m * (1 + 2 * deep_tiles_per_side / sqrt(std::max(1.0, n)));
+                        double region_entries      = deep_entries / tiles;
+                        double region_tiles        = std::min(region_entries, deep_tiles_per_side * deep_tiles_per_side / tiles);
+                        bytes += sizeof(tile_entry) * region_entries + (sizeof(TileID) + sizeof(size_t)) * region_tiles 
+                               + sizeof(EdgeID) * region_entries;
+                }
+                return buckets + bytes;
+        }
+        if( png && config.tiled_rasterizer ) {
+                double entries = m;
+                return buckets + sizeof(tile_entry) * entries + (sizeof(TileID) + sizeof(size_t)) * entries 
+                       + sizeof(uint32_t) * pixels;
+        }
+        if( png ) {
+                return buckets + sizeof(uint32_t) * pixels;
+        }
+        return buckets;
+}
+
+double memory_planner::metrics_bytes( double n, int metric_threads ) {
+        // coordinates, sources and the quadtree of MEnt plus the BFS buffers of every thread
+        return 48 * n + (double)metric_threads * MSBFS_BYTES_PER_NODE * n;
+}
+
+void memory_planner::print_estimate( const memory_estimate & est ) {
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision     = std::cout.precision();
+
+        std::cout <<  std::fixed << std::setprecision(1)
+                  <<  "estimated peak memory: baseline " << est.baseline / (1024 * 1024) 
+                  <<  " MB, drawing " << est.drawing / (1024 * 1024) 
+                  <<  " MB, rendering " << est.rendering / (1024 * 1024) 
+                  <<  " MB, metrics " << est.metrics / (1024 * 1024) << " MB" << std::endl;
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+}
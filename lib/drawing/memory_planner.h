@@ -0,0 +1,69 @@
+/******************************************************************************
+ * memory_planner.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef MEMORY_PLANNER_R6TN3WQE
+#define MEMORY_PLANNER_R6TN3WQE
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+
+// bytes per directed edge of the hash tables of complete_boundary (measured with --memory_report)
+const double BOUNDARY_BYTES_PER_EDGE = 100;
+
+// estimated peak memory of the phases of kadraw in bytes, including the baseline of the process
+struct memory_estimate {
+        double baseline;
+        double drawing;
+        double rendering;
+        double metrics;
+};
+
+// Chooses the algorithms of kadraw such that the estimated peak memory stays below 
+// config.memory_budget (megabytes). The estimates are derived from the sizes of the 
+// data structures for a graph with n nodes and m (undirected) edges, i.e. before the 
+// graph is read. In budget mode coarse levels are released as soon as they are projected 
+// and clusters are contracted with CSR arrays instead of the boundary hash tables. If the 
+// rendering does not fit, edge length colors are computed from a sample and then the density 
+// renderer is used if it needs less. The number of BFS threads of the metrics is lowered 
+// until they fit.
+class memory_planner {
+public:
+        memory_planner();
+        virtual ~memory_planner();
+
+        // returns false if even the leanest choice exceeds the budget
+        bool plan( Config & config, NodeID n, EdgeID m );
+
+        memory_estimate estimate( const Config & config, NodeID n, EdgeID m, int metric_threads );
+
+private:
+        double graph_bytes( double n, double m );
+        double drawing_bytes( const Config & config, double n, double m );
+        double rendering_bytes( const Config & config, double n, double m );
+        double metrics_bytes( double n, int metric_threads );
+
+        void print_estimate( const memory_estimate & estimate );
+};
+
+
+#endif /* end of include guard: MEMORY_PLANNER_R6TN3WQE */
@@ -31,4 +31,20 @@ complete_boundary::complete_boundary(graph_access * G) {
 complete_boundary::~complete_boundary() {
 }
 
+size_t complete_boundary::memory_bytes() {
+        // hash tables allocate one node (next pointer and value) per entry and one pointer per bucket
+        size_t bytes = m_block_infos.capacity() * sizeof(block_informations);
+        bytes += m_pairs.bucket_count() * sizeof(void*);
+        bytes += m_pairs.size() * (sizeof(void*) + sizeof(block_pairs::value_type));
 
+        block_pairs::iterator iter; 
+        for(iter = m_pairs.begin(); iter != m_pairs.end(); iter++ ) { 
+                PartialBoundary * boundaries[2] = { &iter->second.pb_lhs, &iter->second.pb_rhs };
+                for( int i = 0; i < 2; i++) {
+                        is_boundary_node_hashtable & table = boundaries[i]->internal_boundary;
+                        bytes += table.bucket_count() * sizeof(void*);
+                        bytes += table.size() * (sizeof(void*) + sizeof(is_boundary_node_hashtable::value_type));
+                }
+        }
+        return bytes;
+}
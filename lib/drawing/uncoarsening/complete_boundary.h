@@ -48,6 +48,9 @@ class complete_boundary {
                 inline void insert(NodeID node, PartitionID insert_node_into, boundary_pair * pair);
                 inline void getUnderlyingQuotientGraph( graph_access & qgraph );
 
+                // estimate of the bytes held by the block pairs and their boundaries
+                size_t memory_bytes();
+
         private:
                 //updates lazy values that the access functions need
                 inline void update_lazy_values(boundary_pair * pair);
@@ -19,14 +19,18 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <algorithm>
 #include <sstream>
 #include <omp.h>
 #include "local_optimizer.h"
 #include "tools/graph_extractor.h"
+#include "tools/memory_accounting.h"
+#include "tools/prefix_sum.h"
 #include "tools/quality_metrics.h"
+#include "tools/trace_recorder.h"
 #include "burn_drawing/burn_drawing.h"
 
-local_optimizer::local_optimizer() {
+local_optimizer::local_optimizer() : m_level(0) {
 
 }
 
@@ -52,6 +56,57 @@ void local_optimizer::run_maxent_optimization( const Config & config,
         }
 }
 
+void local_optimizer::draw_clusters_independently( const Config & config, graph_access & G, graph_access & Q, CoarseMapping & coarse_mapping ) {
+        forall_nodes(G, node) {
+                G.setPartitionIndex(node, coarse_mapping[node]);
+        } endfor
+        G.set_partition_count(Q.number_of_nodes());
+
+        graph_extractor extractor;
+        std::vector< graph_access > clusters;
+        std::vector< std::vector< NodeID > > mapping;
+        extractor.extract_all_blocks(G, clusters, mapping);
+
+        // the clusters start from the projected coordinates. large clusters are drawn one after another
+        // with all threads, the small ones concurrently (largest first) where nested parallel loops run sequentially
+        std::vector< NodeID > small_clusters;
+        for( NodeID cluster = 0; cluster < clusters.size(); cluster++) {
+                NodeID size = clusters[cluster].number_of_nodes();
+                if( size >= INNER_PARALLEL_CLUSTER_SIZE ) {
+                        draw_cluster( config, G, Q, clusters[cluster], mapping[cluster], cluster );
+                } else if( size > 0 ) {
+                        small_clusters.push_back(cluster);
+                }
+        }
+        std::stable_sort( small_clusters.begin(), small_clusters.end(), [&clusters]( NodeID lhs, NodeID rhs ) { 
+                return clusters[lhs].number_of_nodes() > clusters[rhs].number_of_nodes(); 
+        } );
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for( long i = 0; i < (long)small_clusters.size(); i++) {
+                NodeID cluster = small_clusters[i];
+                draw_cluster( config, G, Q, clusters[cluster], mapping[cluster], cluster );
+        }
+}
+
+void local_optimizer::draw_cluster( const Config & config, graph_access & G, graph_access & Q, 
+                                    graph_access & C, std::vector< NodeID > & mapping, NodeID cluster ) {
+        run_maxent_optimization_internal( config, C );
+
+        CoordType center_x = 0;
+        CoordType center_y = 0;
+        forall_nodes(C, node) {
+                center_x += C.getX(node);
+                center_y += C.getY(node);
+        } endfor
+        center_x = Q.getX(cluster) - center_x / C.number_of_nodes();
+        center_y = Q.getY(cluster) - center_y / C.number_of_nodes();
+
+        forall_nodes(C, node) {
+                G.setCoords(mapping[node], C.getX(node) + center_x, C.getY(node) + center_y);
+        } endfor
+}
+
 void local_optimizer::run_maxent_optimization_internal( const Config & config, graph_access & G ) {
         if(G.number_of_edges() == 0) return;
 
@@ -62,12 +117,17 @@ void local_optimizer::run_maxent_optimization_internal( const Config & config, g
 
         std::vector<CoordType> distances(G.number_of_edges(),0); 
         configure_distances( config, G, distances);
+        memory_accounting::record("new_coord", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  new_coord.size() * sizeof(coord_t), 0, MEMORY_TEMPORARY);
+        memory_accounting::record("distances", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  0, distances.size() * sizeof(CoordType), MEMORY_TEMPORARY);
 
         for( int i = 0; i < config.maxent_outer_iterations; i++) {
 
                 CoordType norm_coords = 0;
                 CoordType norm_diff = 0;
                 do {
+                        trace_scope scope("maxent iteration");
                         forall_nodes_parallel(G, node) {
                                 CoordType rho_i = 0; // assume graph is connected?
                                 if(G.getNodeDegree(node) == 0) continue;
@@ -161,45 +221,49 @@ void local_optimizer::run_maxent_optimization_internal_fast_approx( const Config
 
         std::vector<CoordType> distances(G.number_of_edges(),0); 
         configure_distances(config, G, distances);
+        memory_accounting::record("new_coord", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  new_coord.size() * sizeof(coord_t), 0, MEMORY_TEMPORARY);
+        memory_accounting::record("distances", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  0, distances.size() * sizeof(CoordType), MEMORY_TEMPORARY);
 
-        // build cluster ID to nodes array
+        // build cluster ID to nodes array, the nodes of cluster c are 
+        // cluster_nodes[cluster_start[c]], ..., cluster_nodes[cluster_start[c+1]-1]
         NodeID num_clusters = Q.number_of_nodes();
-        std::vector< std::vector< std::vector< NodeID > > > cluster_to_nodes_local(omp_get_max_threads());
         std::vector< NodeID > cluster_vertex_count(num_clusters,0);
-
-        for( int i = 0; i < omp_get_max_threads(); i++) {
-                cluster_to_nodes_local[i].resize(num_clusters);
-        }
-        forall_nodes_parallel(G, node) {
-                NodeID cluster_id = (*coarse_mapping)[node];
-                cluster_to_nodes_local[omp_get_thread_num()][cluster_id].push_back(node);
+        forall_nodes(G, node) {
+                cluster_vertex_count[(*coarse_mapping)[node]]++;
         } endfor
 
-        //compute num nodes in cluster
-        forall_nodes_parallel(Q, cluster_id) {
-                NodeID cluster_size = 0;
-                for( int thread_num = 0; thread_num < omp_get_max_threads(); thread_num++) {
-                        cluster_size += cluster_to_nodes_local[thread_num][cluster_id].size();
-                }
-                cluster_vertex_count[cluster_id] = cluster_size;
-        } endfor
+        std::vector< NodeID > cluster_start(cluster_vertex_count);
+        cluster_start.push_back(0);
+        parallel_prefix_sum(cluster_start);
+
+        std::vector< NodeID > cluster_nodes(G.number_of_nodes());
+        {
+                std::vector< NodeID > insert_pos(cluster_start.begin(), cluster_start.end()-1);
+                forall_nodes(G, node) {
+                        cluster_nodes[insert_pos[(*coarse_mapping)[node]]++] = node;
+                } endfor
+        }
+        memory_accounting::record("cluster membership", m_level, G.number_of_nodes(), G.number_of_edges(), 
+                                  (cluster_nodes.size() + cluster_start.size() + cluster_vertex_count.size()) * sizeof(NodeID), 
+                                  0, MEMORY_TEMPORARY);
 
         for( int i = 0; i < config.maxent_outer_iterations; i++) {
                 CoordType norm_coords = 0;
                 CoordType norm_diff = 0;
                 do {
+                        trace_scope scope("maxent iteration");
 
                         //update coordinates of coarse nodes
                         forall_nodes_parallel(Q, coarse_node) {
                                 CoordType X_bar = 0;
                                 CoordType Y_bar = 0;
 
-                                for( int thread_num = 0; thread_num < omp_get_max_threads(); thread_num++) {
-                                        for( unsigned int i = 0; i < cluster_to_nodes_local[thread_num][coarse_node].size(); i++) {
-                                                NodeID cur_node = cluster_to_nodes_local[thread_num][coarse_node][i];
-                                                X_bar += G.getNodeWeight(cur_node)*G.getX(cur_node);
-                                                Y_bar += G.getNodeWeight(cur_node)*G.getY(cur_node);
-                                        }
+                                for( NodeID i = cluster_start[coarse_node]; i < cluster_start[coarse_node+1]; i++) {
+                                        NodeID cur_node = cluster_nodes[i];
+                                        X_bar += G.getNodeWeight(cur_node)*G.getX(cur_node);
+                                        Y_bar += G.getNodeWeight(cur_node)*G.getY(cur_node);
                                 }
                                 X_bar /= Q.getNodeWeight(coarse_node);
                                 Y_bar /= Q.getNodeWeight(coarse_node);
@@ -261,20 +325,18 @@ void local_optimizer::run_maxent_optimization_internal_fast_approx( const Config
                                 } endfor
 
                                 // compute repulsive within cluster explicitly
-                                for( int thread_num = 0; thread_num < omp_get_max_threads(); thread_num++) {
-                                        for( unsigned int i = 0; i < cluster_to_nodes_local[thread_num][coarser_node].size(); i++) {
-                                                NodeID target = cluster_to_nodes_local[thread_num][coarser_node][i];
-                                                if( node == target ) continue;
-
-                                                CoordType diffX       = G.getX(node) - G.getX(target);
-                                                CoordType diffY       = G.getY(node) - G.getY(target);
-                                                CoordType dist_square = diffX*diffX+diffY*diffY;
-                                                CoordType dist        = sqrt(dist_square);
-
-                                                CoordType dist_q = pow(dist, q+2);
-                                                n_S_x += diffX/dist_q;
-                                                n_S_y += diffY/dist_q;
-                                        }
+                                for( NodeID i = cluster_start[coarser_node]; i < cluster_start[coarser_node+1]; i++) {
+                                        NodeID target = cluster_nodes[i];
+                                        if( node == target ) continue;
+
+                                        CoordType diffX       = G.getX(node) - G.getX(target);
+                                        CoordType diffY       = G.getY(node) - G.getY(target);
+                                        CoordType dist_square = diffX*diffX+diffY*diffY;
+                                        CoordType dist        = sqrt(dist_square);
+
+                                        CoordType dist_q = pow(dist, q+2);
+                                        n_S_x += diffX/dist_q;
+                                        n_S_y += diffY/dist_q;
                                 }
 
                                 n_S_x *= alpha*rho_i;
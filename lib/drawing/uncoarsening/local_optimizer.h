@@ -29,6 +29,10 @@
 #include "tools/random_functions.h"
 #include "io/graph_io.h"
 
+// clusters with at least this many nodes are drawn one after another using all threads,
+// smaller clusters are drawn concurrently with one thread each
+const NodeID INNER_PARALLEL_CLUSTER_SIZE = 2000;
+
 struct coord_t {
         CoordType x;
         CoordType y;
@@ -46,10 +50,23 @@ class local_optimizer {
 
                 void run_maxent_optimization( const Config & config, graph_access & G, graph_access * coarse_graph = NULL, CoarseMapping * coarse_mapping = NULL); 
 
+                // lays out every cluster of G (given by coarse_mapping) on its own and in parallel, 
+                // then moves the centroid of each cluster to the position of its node in Q.
+                // the partition index of every node of G is overwritten with its cluster (coarse_mapping), 
+                // on the finest level coarsening already stored these indices for the edge distances
+                void draw_clusters_independently( const Config & config, graph_access & G, graph_access & Q, CoarseMapping & coarse_mapping );
+
+                // level of the hierarchy the following optimizations run on, used for memory accounting
+                void set_level( int level ) { m_level = level; }
+
         private:   
                 void configure_distances( const Config & config, graph_access & G, std::vector< CoordType > & distances  );
                 void run_maxent_optimization_internal( const Config & config, graph_access & G );
+                void draw_cluster( const Config & config, graph_access & G, graph_access & Q, 
+                                   graph_access & C, std::vector< NodeID > & mapping, NodeID cluster );
                 void run_maxent_optimization_internal_fast_approx( const Config & config, graph_access & G, graph_access & Q, CoarseMapping* coarse_mapping );
+
+                int m_level;
 };
 
 
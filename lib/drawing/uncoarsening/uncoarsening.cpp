@@ -20,6 +20,9 @@
  *****************************************************************************/
 
 
+#include "burn_drawing/preview_writer.h"
+#include "tools/memory_accounting.h"
+#include "tools/trace_recorder.h"
 #include "uncoarsening.h"
 #include "local_optimizer.h"
 
@@ -36,45 +39,85 @@ int uncoarsening::perform_uncoarsening(const Config & config, graph_hierarchy &
         Config cfg = config;
         local_optimizer lopt;
         graph_access * coarsest = hierarchy.get_coarsest();
-        PRINT(std::cout << "log>" << "unrolling graph with " << coarsest->number_of_nodes() << std::endl;)
+        if(!config.quiet) PRINT(std::cout << "log>" << "unrolling graph with " << coarsest->number_of_nodes() << std::endl;)
 
-        Config tmp = config;
-        tmp.draw_cluster_first = false;
-        lopt.run_maxent_optimization(tmp, *coarsest, NULL, NULL);
+        {
+                trace_scope scope("initial layout", coarsest->number_of_nodes());
+                lopt.set_level(hierarchy.number_of_levels() - 1);
+                lopt.run_maxent_optimization(config, *coarsest, NULL, NULL);
+        }
+
+        // previews of all levels but the finest one, which is the actual output
+        preview_writer previews;
+        int level = 0;
+        if( config.write_previews && !hierarchy.isEmpty() ) {
+                previews.write_preview(config, *coarsest, level);
+        }
 
         graph_access* coarser = NULL;
+        graph_access* quotient = coarsest;
+        int uncoarsening_level = 0;
 
         while(!hierarchy.isEmpty()) {
-                graph_access* G = hierarchy.pop_finer_and_project();
-                PRINT(std::cout << "log>" << "unrolling graph with " << G->number_of_nodes()<<  std::endl;)
+                trace_scope level_scope("uncoarsening level", ++uncoarsening_level);
+                graph_access* G = NULL;
+                {
+                        trace_scope scope("projection");
+                        G = hierarchy.pop_finer_and_project();
+                }
+                if(!config.quiet) PRINT(std::cout << "log>" << "unrolling graph with " << G->number_of_nodes()<<  std::endl;)
 
                 CoarseMapping* coarse_mapping = hierarchy.get_mapping_of_current_finer();
+                lopt.set_level(hierarchy.size());
+
+                // on the finest level the clusters of the first clustering are drawn on their own,
+                // placed at their nodes in the coarser graph and then optionally fine tuned together
+                bool fine_tune = true;
+                if( config.draw_cluster_first && hierarchy.isEmpty() ) {
+                        trace_scope scope("draw clusters");
+                        lopt.draw_clusters_independently(config, *G, *quotient, *coarse_mapping);
+                        fine_tune = !config.draw_cluster_first_disable_fine_tune;
+                }
                 
                 //call refinement
-                if( G->number_of_edges() ) {
+                if( G->number_of_edges() && fine_tune ) {
                         Config cfg = config;
                         cfg.last_level = hierarchy.isEmpty();
                         if( config.faster_drawing && config.faster_drawing_num_levels > 1 ) {
                                 CoarseMapping* direct_coarse_mapping = NULL;
-                                if(config.faster_mapping) {
-                                        direct_coarse_mapping = hierarchy.get_mapping_plus_x_faster(config.faster_drawing_num_levels);
-                                } else {
-                                        direct_coarse_mapping = hierarchy.get_mapping_plus_x(config.faster_drawing_num_levels);
+                                {
+                                        trace_scope scope("mapping");
+                                        if(config.faster_mapping) {
+                                                direct_coarse_mapping = hierarchy.get_mapping_plus_x_faster(config.faster_drawing_num_levels);
+                                        } else {
+                                                direct_coarse_mapping = hierarchy.get_mapping_plus_x(config.faster_drawing_num_levels);
+                                        }
                                 }
 
+                                memory_accounting::record("mapping plus x", hierarchy.size(), G->number_of_nodes(), G->number_of_edges(),
+                                                          direct_coarse_mapping->size() * sizeof(NodeID), 0, MEMORY_TEMPORARY);
+
                                 graph_access*  direct_coarser = hierarchy.get_coarser_plus_x(config.faster_drawing_num_levels);
+                                trace_scope scope("refinement", G->number_of_nodes());
                                 lopt.run_maxent_optimization(cfg, *G, direct_coarser, direct_coarse_mapping);
                                 delete direct_coarse_mapping;
                         } else {
+                                trace_scope scope("refinement", G->number_of_nodes());
                                 lopt.run_maxent_optimization(cfg, *G, coarser, coarse_mapping);
                         }
                 }
 
 		if(!hierarchy.isEmpty()) {
-			coarser = G;
+			coarser  = G;
+			quotient = G;
+                        if( config.write_previews ) {
+                                trace_scope scope("preview");
+                                previews.write_preview(config, *G, ++level);
+                        }
 		}
 
         }
+        previews.wait();
 
         return 0;
 }
@@ -20,7 +20,9 @@
  *****************************************************************************/
 
 
+#include <algorithm>
 #include <sstream>
+#include <stdint.h>
 #include "graph_io.h"
 
 graph_io::graph_io() {
@@ -110,6 +112,32 @@ int graph_io::readPartition(graph_access & G, std::string filename) {
         return 0;
 }
 
+int graph_io::readGraphHeader(std::string filename, NodeID & n, EdgeID & m) {
+        std::string line;
+
+        std::ifstream in(filename.c_str());
+        if (!in) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        std::getline(in,line);
+        //skip comments
+        while( in && line[0] == '%' ) {
+                std::getline(in, line);
+        }
+
+        long nmbNodes = 0;
+        long nmbEdges = 0;
+        std::stringstream ss(line);
+        ss >> nmbNodes;
+        ss >> nmbEdges;
+
+        n = nmbNodes;
+        m = nmbEdges;
+        return 0;
+}
+
 int graph_io::readGraphWeighted(graph_access & G, std::string filename) {
         std::string line;
 
@@ -262,3 +290,208 @@ void graph_io::writeCoordinates(graph_access & G, std::string filename) {
         } endfor
         f.close();
 }
+
+static const char HIERARCHY_MAGIC[8]     = {'K', 'D', 'H', 'I', 'E', 'R', 0, 0};
+static const uint32_t HIERARCHY_VERSION  = 1;
+
+template<typename T>
+static void write_binary(std::ofstream & f, const std::vector< T > & values) {
+        if( values.size() > 0 ) {
+                f.write((const char*) &values[0], values.size() * sizeof(T));
+        }
+}
+
+template<typename T>
+static bool read_binary(std::ifstream & f, std::vector< T > & values, size_t count) {
+        values.resize(count);
+        if( count > 0 ) {
+                f.read((char*) &values[0], count * sizeof(T));
+        }
+        return (bool) f;
+}
+
+int graph_io::writeHierarchy(std::vector< graph_access* > & levels, std::vector< CoarseMapping* > & mappings, std::string filename) {
+        std::ofstream f(filename.c_str(), std::ios::binary);
+        if (!f) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        uint32_t num_levels = levels.size();
+        f.write(HIERARCHY_MAGIC, 8);
+        f.write((const char*) &HIERARCHY_VERSION, sizeof(uint32_t));
+        f.write((const char*) &num_levels, sizeof(uint32_t));
+
+        // level table, the offsets follow from the sizes of the levels
+        uint64_t offset = 16 + (uint64_t)num_levels * 24;
+        for( unsigned level = 0; level < num_levels; level++) {
+                graph_access & G = *levels[level];
+                uint32_t entry[4];
+                entry[0] = G.number_of_nodes();
+                entry[1] = G.number_of_edges();
+                entry[2] = mappings[level] != NULL;
+                entry[3] = 0;
+                f.write((const char*) entry, sizeof(entry));
+                f.write((const char*) &offset, sizeof(uint64_t));
+
+                uint64_t n = entry[0], m = entry[1];
+                offset += 4 * (n + n + n + (n + 1) + m + m + (entry[2] ? n : 0));
+        }
+
+        for( unsigned level = 0; level < num_levels; level++) {
+                graph_access & G = *levels[level];
+                NodeID n = G.number_of_nodes();
+                EdgeID m = G.number_of_edges();
+                {
+                        std::vector< float > x(n), y(n);
+                        std::vector< uint32_t > node_weight(n);
+                        forall_nodes(G, node) {
+                                x[node]           = G.getX(node);
+                                y[node]           = G.getY(node);
+                                node_weight[node] = G.getNodeWeight(node);
+                        } endfor
+                        write_binary(f, x);
+                        write_binary(f, y);
+                        write_binary(f, node_weight);
+                }
+                {
+                        std::vector< uint32_t > xadj(n + 1);
+                        std::vector< uint32_t > adjncy(m);
+                        std::vector< int32_t > edge_weight(m);
+                        forall_nodes(G, node) {
+                                xadj[node] = G.get_first_edge(node);
+                                forall_out_edges(G, e, node) {
+                                        adjncy[e]      = G.getEdgeTarget(e);
+                                        edge_weight[e] = G.getEdgeWeight(e);
+                                } endfor
+                        } endfor
+                        xadj[n] = m;
+                        write_binary(f, xadj);
+                        write_binary(f, adjncy);
+                        write_binary(f, edge_weight);
+                }
+                if( mappings[level] != NULL ) {
+                        std::vector< uint32_t > mapping(mappings[level]->begin(), mappings[level]->end());
+                        write_binary(f, mapping);
+                }
+        }
+
+        f.close();
+        if (!f) {
+                std::cerr << "Error writing " << filename << std::endl;
+                return 1;
+        }
+        return 0;
+}
+
+static bool read_hierarchy_header(std::ifstream & in, std::string & filename, uint32_t & num_levels) {
+        char magic[8];
+        uint32_t version = 0;
+        in.read(magic, 8);
+        in.read((char*) &version, sizeof(uint32_t));
+        in.read((char*) &num_levels, sizeof(uint32_t));
+        if (!in || !std::equal(magic, magic + 8, HIERARCHY_MAGIC) || version != HIERARCHY_VERSION) {
+                std::cerr << filename << " is not a hierarchy file of version " << HIERARCHY_VERSION << std::endl;
+                return false;
+        }
+        return true;
+}
+
+int graph_io::readHierarchyNumberOfLevels(std::string filename, unsigned & num_levels) {
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        if (!in) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        uint32_t levels = 0;
+        if( !read_hierarchy_header(in, filename, levels) ) return 1;
+        num_levels = levels;
+        return 0;
+}
+
+int graph_io::readHierarchyLevel(std::string filename, unsigned level, graph_access & G, std::vector< NodeID > & mapping) {
+        std::ifstream in(filename.c_str(), std::ios::binary);
+        if (!in) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return 1;
+        }
+
+        uint32_t num_levels = 0;
+        if( !read_hierarchy_header(in, filename, num_levels) ) return 1;
+        if( level >= num_levels ) {
+                std::cerr << filename << " has only " << num_levels << " levels" << std::endl;
+                return 1;
+        }
+
+        in.seekg(0, std::ios::end);
+        uint64_t file_size = in.tellg();
+
+        uint32_t entry[4];
+        uint64_t offset = 0;
+        in.seekg(16 + (uint64_t)level * 24);
+        in.read((char*) entry, sizeof(entry));
+        in.read((char*) &offset, sizeof(uint64_t));
+
+        // the mapping points into the next coarser level
+        uint32_t coarser_n = 0;
+        if( in && entry[2] && level + 1 < num_levels ) {
+                in.seekg(16 + (uint64_t)(level + 1) * 24);
+                in.read((char*) &coarser_n, sizeof(uint32_t));
+        }
+
+        // the level has to lie within the file before anything is allocated
+        uint64_t level_bytes = 4 * ((uint64_t)entry[0] * 4 + 1 + (uint64_t)entry[1] * 2 + (entry[2] ? entry[0] : 0));
+        if( !in || offset > file_size || level_bytes > file_size - offset || (entry[2] && level + 1 >= num_levels) ) {
+                std::cerr << "Error reading level " << level << " of " << filename << ": corrupt level table" << std::endl;
+                return 1;
+        }
+        in.seekg(offset);
+
+        NodeID n = entry[0];
+        EdgeID m = entry[1];
+        std::vector< float > x, y;
+        std::vector< uint32_t > node_weight, xadj, adjncy, coarse_mapping;
+        std::vector< int32_t > edge_weight;
+        bool ok = read_binary(in, x, n) && read_binary(in, y, n) && read_binary(in, node_weight, n)
+               && read_binary(in, xadj, n + 1) && read_binary(in, adjncy, m) && read_binary(in, edge_weight, m);
+        if( ok && entry[2] ) {
+                ok = read_binary(in, coarse_mapping, n);
+        }
+        if( !ok ) {
+                std::cerr << "Error reading level " << level << " of " << filename << std::endl;
+                return 1;
+        }
+
+        // a truncated or foreign file must not reach the graph construction
+        bool valid = xadj[0] == 0 && xadj[n] == m;
+        for( NodeID node = 0; node < n && valid; node++) {
+                valid = xadj[node] <= xadj[node+1];
+        }
+        for( EdgeID e = 0; e < m && valid; e++) {
+                valid = adjncy[e] < n;
+        }
+        for( NodeID node = 0; node < coarse_mapping.size() && valid; node++) {
+                valid = coarse_mapping[node] < coarser_n;
+        }
+        if( !valid ) {
+                std::cerr << "Error reading level " << level << " of " << filename << ": invalid graph data" << std::endl;
+                return 1;
+        }
+
+        G.start_construction(n, m);
+        for( NodeID node = 0; node < n; node++) {
+                NodeID shadow_node = G.new_node();
+                G.setNodeWeight(shadow_node, node_weight[node]);
+                G.setPartitionIndex(shadow_node, 0);
+                G.setCoords(shadow_node, x[node], y[node]);
+                for( EdgeID e = xadj[node]; e < xadj[node+1]; e++) {
+                        EdgeID shadow_edge = G.new_edge(shadow_node, adjncy[e]);
+                        G.setEdgeWeight(shadow_edge, edge_weight[e]);
+                }
+        }
+        G.finish_construction();
+
+        mapping.assign(coarse_mapping.begin(), coarse_mapping.end());
+        return 0;
+}
@@ -45,6 +45,10 @@ class graph_io {
                 static 
                 int readGraphWeighted(graph_access & G, std::string filename);
 
+                // reads only the number of nodes and (undirected) edges from the first line
+                static 
+                int readGraphHeader(std::string filename, NodeID & n, EdgeID & m);
+
                 static
                 int writeGraphWeighted(graph_access & G, std::string filename);
 
@@ -63,6 +67,24 @@ class graph_io {
                 static
                 void writeCoordinates(graph_access & G, std::string filename);
 
+                // binary multi-resolution file, levels[0] is the finest graph and mappings[i]
+                // maps the nodes of level i to level i+1 (NULL for the coarsest level).
+                //
+                // layout (native byte order):
+                //   char[8] magic "KDHIER\0\0", uint32 version, uint32 number of levels
+                //   per level: uint32 n, uint32 m, uint32 has mapping, uint32 0, uint64 offset of the level data
+                //   level data: float x[n], float y[n], uint32 node weight[n], uint32 xadj[n+1],
+                //               uint32 adjncy[m], int32 edge weight[m], uint32 mapping[n] (if present)
+                static
+                int writeHierarchy(std::vector< graph_access* > & levels, std::vector< CoarseMapping* > & mappings, std::string filename);
+
+                // reads only the given level of a hierarchy file, mapping is empty for the coarsest level
+                static
+                int readHierarchyLevel(std::string filename, unsigned level, graph_access & G, std::vector< NodeID > & mapping);
+
+                static
+                int readHierarchyNumberOfLevels(std::string filename, unsigned & num_levels);
+
                 template<typename vectortype> 
                 static void writeVector(std::vector<vectortype> & vec, std::string filename);
 
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * connected_components.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "connected_components.h"
+#include "prefix_sum.h"
+
+connected_components::connected_components() {
+
+}
+
+connected_components::~connected_components() {
+
+}
+
+NodeID connected_components::compute_components( graph_access & G, std::vector< NodeID > & component ) {
+        long n = G.number_of_nodes();
+        std::vector< NodeID > parent(n);
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                parent[node] = node;
+        }
+
+        // link a sparse subgraph first, it usually connects most of the largest component
+        for( int round = 0; round < AFFOREST_NEIGHBOR_ROUNDS; round++) {
+                #pragma omp parallel for schedule(dynamic, 1024)
+                for( long node = 0; node < n; node++) {
+                        EdgeID e = G.get_first_edge(node) + round;
+                        if( e < G.get_first_invalid_edge(node) ) {
+                                link(node, G.getEdgeTarget(e), parent);
+                        }
+                }
+                compress(parent);
+        }
+
+        // the remaining edges of nodes in the largest component need not be scanned since
+        // every edge leaving it is also stored at its other endpoint
+        m_frequent_root = most_frequent_root(parent);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for( long node = 0; node < n; node++) {
+                if( parent[node] == m_frequent_root ) continue;
+
+                EdgeID end = G.get_first_invalid_edge(node);
+                for( EdgeID e = G.get_first_edge(node) + AFFOREST_NEIGHBOR_ROUNDS; e < end; e++) {
+                        link(node, G.getEdgeTarget(e), parent);
+                }
+        }
+        compress(parent);
+
+        return relabel(parent, component);
+}
+
+NodeID connected_components::compute_components( graph_access & G, std::vector< NodeID > & component,
+                                                 std::vector< NodeID > & sizes ) {
+        NodeID num_components = compute_components(G, component);
+        NodeID frequent       = num_components > 0 ? component[m_frequent_root] : 0;
+
+        // the largest component is counted locally, all others with atomic increments
+        long n = G.number_of_nodes();
+        NodeID frequent_size = 0;
+        sizes.assign(num_components, 0);
+        #pragma omp parallel for schedule(static) reduction(+:frequent_size)
+        for( long node = 0; node < n; node++) {
+                if( component[node] == frequent ) {
+                        frequent_size++;
+                } else {
+                        __sync_fetch_and_add(&sizes[component[node]], 1);
+                }
+        }
+        if( num_components > 0 ) sizes[frequent] = frequent_size;
+
+        return num_components;
+}
+
+void connected_components::link( NodeID lhs, NodeID rhs, std::vector< NodeID > & parent ) {
+        // the larger root is hooked below the smaller one, so every root is the smallest node of its tree
+        NodeID p_lhs = parent[lhs];
+        NodeID p_rhs = parent[rhs];
+        while( p_lhs != p_rhs ) {
+                NodeID high        = std::max(p_lhs, p_rhs);
+                NodeID low         = std::min(p_lhs, p_rhs);
+                NodeID parent_high = parent[high];
+                if( parent_high == low ) break;
+                if( parent_high == high && __sync_bool_compare_and_swap(&parent[high], high, low) ) break;
+
+                p_lhs = parent[parent[high]];
+                p_rhs = parent[low];
+        }
+}
+
+void connected_components::compress( std::vector< NodeID > & parent ) {
+        long n = parent.size();
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for( long node = 0; node < n; node++) {
+                while( parent[node] != parent[parent[node]] ) {
+                        parent[node] = parent[parent[node]];
+                }
+        }
+}
+
+NodeID connected_components::most_frequent_root( std::vector< NodeID > & parent ) {
+        if( parent.empty() ) return 0;
+
+        // evenly spaced samples, the random generator is left untouched
+        std::unordered_map< NodeID, NodeID > count;
+        NodeID n = parent.size();
+        NodeID samples = std::min(n, AFFOREST_SAMPLES);
+        for( NodeID i = 0; i < samples; i++) {
+                count[parent[(unsigned long long) i * n / samples]]++;
+        }
+
+        NodeID root      = parent[0];
+        NodeID max_count = 0;
+        for( auto it : count ) {
+                if( it.second > max_count || (it.second == max_count && it.first < root) ) {
+                        max_count = it.second;
+                        root      = it.first;
+                }
+        }
+        return root;
+}
+
+NodeID connected_components::relabel( std::vector< NodeID > & parent, std::vector< NodeID > & component ) {
+        long n = parent.size();
+        std::vector< NodeID > root_id(n);
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                root_id[node] = parent[node] == (NodeID)node ? 1 : 0;
+        }
+        NodeID num_components = parallel_prefix_sum(root_id);
+
+        component.resize(n);
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                component[node] = root_id[parent[node]];
+        }
+        return num_components;
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * connected_components.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef CONNECTED_COMPONENTS_N5RKD2QW
+#define CONNECTED_COMPONENTS_N5RKD2QW
+
+#include <vector>
+
+#include "data_structure/graph_access.h"
+
+// number of edges per node that are linked before the largest component is guessed
+const int AFFOREST_NEIGHBOR_ROUNDS = 2;
+// number of nodes that are sampled to guess the largest component
+const NodeID AFFOREST_SAMPLES = 1024;
+
+// Parallel connected components of an undirected graph (Afforest, Sutton et al. 2018).
+// The components are kept as trees in a parent array that are linked with compare-and-swap.
+// After linking the first few edges of every node, most nodes already belong to the largest
+// component, and the remaining edges are only scanned for nodes outside of it.
+class connected_components {
+public:
+        connected_components();
+        virtual ~connected_components();
+
+        // component[node] is in [0, number of components), the components are numbered by
+        // their smallest node. returns the number of components.
+        NodeID compute_components( graph_access & G, std::vector< NodeID > & component );
+
+        // as above, additionally sizes[c] is the number of nodes in component c
+        NodeID compute_components( graph_access & G, std::vector< NodeID > & component,
+                                   std::vector< NodeID > & sizes );
+
+private:
+        void link( NodeID lhs, NodeID rhs, std::vector< NodeID > & parent );
+        void compress( std::vector< NodeID > & parent );
+        NodeID most_frequent_root( std::vector< NodeID > & parent );
+        NodeID relabel( std::vector< NodeID > & parent, std::vector< NodeID > & component );
+
+        // root of the component that contained most of the samples
+        NodeID m_frequent_root;
+};
+
+
+#endif /* end of include guard: CONNECTED_COMPONENTS_N5RKD2QW */
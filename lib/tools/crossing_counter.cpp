@@ -0,0 +1,262 @@
+/******************************************************************************
+ * crossing_counter.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <math.h>
+#include <omp.h>
+
+#include "crossing_counter.h"
+#include "random_functions.h"
+
+crossing_counter::crossing_counter() {
+
+}
+
+crossing_counter::~crossing_counter() {
+
+}
+
+void crossing_counter::count_crossings( graph_access & G, EdgeID sample_size, crossing_stats & stats ) {
+        stats.crossings          = 0;
+        stats.confidence         = 0;
+        stats.crossings_per_edge = 0;
+        stats.max_edge_crossings = 0;
+        stats.evaluated_edges    = 0;
+
+        build_grid(G);
+        if( m_source.empty() ) return;
+
+        if( sample_size == 0 || sample_size >= m_source.size() ) {
+                count_all(stats);
+        } else {
+                count_sample(sample_size, stats);
+        }
+        stats.crossings_per_edge = 2 * stats.crossings / m_source.size();
+}
+
+void crossing_counter::build_grid( graph_access & G ) {
+        m_x.resize(G.number_of_nodes());
+        m_y.resize(G.number_of_nodes());
+        m_source.clear();
+        m_target.clear();
+
+        double x_max = 0, y_max = 0;
+        m_x_min = m_y_min = 0;
+        forall_nodes(G, node) {
+                m_x[node] = G.getX(node);
+                m_y[node] = G.getY(node);
+                if( node == 0 ) {
+                        m_x_min = x_max = m_x[node];
+                        m_y_min = y_max = m_y[node];
+                }
+                m_x_min = std::min(m_x_min, m_x[node]);
+                m_y_min = std::min(m_y_min, m_y[node]);
+                x_max   = std::max(x_max, m_x[node]);
+                y_max   = std::max(y_max, m_y[node]);
+
+                forall_out_edges(G, e, node) {
+                        NodeID target = G.getEdgeTarget(e);
+                        if( node < target ) {
+                                m_source.push_back(node);
+                                m_target.push_back(target);
+                        }
+                } endfor
+        } endfor
+
+        // square cells, about one per segment
+        double width  = std::max(x_max - m_x_min, 1e-12);
+        double height = std::max(y_max - m_y_min, 1e-12);
+        double cells  = std::max((double)m_source.size(), 1.0);
+        m_cell_size   = std::max(sqrt(width * height / cells), std::max(width, height) / cells);
+        m_columns     = std::min((double)cells, floor(width / m_cell_size)) + 1;
+        m_rows        = std::min((double)cells, floor(height / m_cell_size)) + 1;
+
+        unsigned num_cells = m_columns * m_rows;
+        m_cell_start.assign(num_cells + 1, 0);
+
+        // count the segments of every cell, then fill the cells
+        long num_segments = m_source.size();
+        #pragma omp parallel
+        {
+                std::vector< unsigned > cells;
+                #pragma omp for schedule(dynamic, 1024)
+                for( long segment = 0; segment < num_segments; segment++) {
+                        segment_cells(segment, cells);
+                        for( unsigned i = 0; i < cells.size(); i++) {
+                                __sync_fetch_and_add(&m_cell_start[cells[i] + 1], 1);
+                        }
+                }
+        }
+
+        for( unsigned cell = 0; cell < num_cells; cell++) {
+                m_cell_start[cell + 1] += m_cell_start[cell];
+        }
+
+        std::vector< EdgeID > fill(m_cell_start.begin(), m_cell_start.end() - 1);
+        m_cell_segments.resize(m_cell_start[num_cells]);
+        #pragma omp parallel
+        {
+                std::vector< unsigned > cells;
+                #pragma omp for schedule(dynamic, 1024)
+                for( long segment = 0; segment < num_segments; segment++) {
+                        segment_cells(segment, cells);
+                        for( unsigned i = 0; i < cells.size(); i++) {
+                                m_cell_segments[__sync_fetch_and_add(&fill[cells[i]], 1)] = segment;
+                        }
+                }
+        }
+}
+
+void crossing_counter::segment_cells( EdgeID segment, std::vector< unsigned > & cells ) {
+        cells.clear();
+
+        double x0 = m_x[m_source[segment]], y0 = m_y[m_source[segment]];
+        double x1 = m_x[m_target[segment]], y1 = m_y[m_target[segment]];
+        if( x1 < x0 ) {
+                std::swap(x0, x1);
+                std::swap(y0, y1);
+        }
+
+        // column by column, the rows between the heights of the segment at the column borders.
+        // ranges are widened a little so that a crossing point never ends up in a cell that misses a segment
+        double epsilon = 1e-7 * m_cell_size;
+        int first_column = std::max(0, (int)floor((x0 - epsilon - m_x_min) / m_cell_size));
+        int last_column  = std::min((int)m_columns - 1, (int)floor((x1 + epsilon - m_x_min) / m_cell_size));
+        for( int column = first_column; column <= last_column; column++) {
+                double y_low = y0, y_high = y1;
+                if( x1 > x0 ) {
+                        double slope = (y1 - y0) / (x1 - x0);
+                        double left  = std::max(x0, m_x_min + column * m_cell_size);
+                        double right = std::min(x1, m_x_min + (column + 1) * m_cell_size);
+                        y_low  = y0 + (left - x0) * slope;
+                        y_high = y0 + (right - x0) * slope;
+                }
+                if( y_high < y_low ) std::swap(y_low, y_high);
+
+                int first_row = std::max(0, (int)floor((y_low - epsilon - m_y_min) / m_cell_size));
+                int last_row  = std::min((int)m_rows - 1, (int)floor((y_high + epsilon - m_y_min) / m_cell_size));
+                for( int row = first_row; row <= last_row; row++) {
+                        cells.push_back(row * m_columns + column);
+                }
+        }
+}
+
+unsigned crossing_counter::cell_of_point( double x, double y ) {
+        int column = std::min((int)m_columns - 1, std::max(0, (int)floor((x - m_x_min) / m_cell_size)));
+        int row    = std::min((int)m_rows - 1, std::max(0, (int)floor((y - m_y_min) / m_cell_size)));
+        return row * m_columns + column;
+}
+
+static inline double orientation( double ax, double ay, double bx, double by, double cx, double cy ) {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+bool crossing_counter::segments_cross( EdgeID lhs, EdgeID rhs, double & x, double & y ) {
+        NodeID a = m_source[lhs], b = m_target[lhs];
+        NodeID c = m_source[rhs], d = m_target[rhs];
+        if( a == c || a == d || b == c || b == d ) return false;
+
+        double o1 = orientation(m_x[a], m_y[a], m_x[b], m_y[b], m_x[c], m_y[c]);
+        double o2 = orientation(m_x[a], m_y[a], m_x[b], m_y[b], m_x[d], m_y[d]);
+        if( !((o1 < 0 && o2 > 0) || (o1 > 0 && o2 < 0)) ) return false;
+
+        double o3 = orientation(m_x[c], m_y[c], m_x[d], m_y[d], m_x[a], m_y[a]);
+        double o4 = orientation(m_x[c], m_y[c], m_x[d], m_y[d], m_x[b], m_y[b]);
+        if( !((o3 < 0 && o4 > 0) || (o3 > 0 && o4 < 0)) ) return false;
+
+        double t = o3 / (o3 - o4);
+        x = m_x[a] + t * (m_x[b] - m_x[a]);
+        y = m_y[a] + t * (m_y[b] - m_y[a]);
+        return true;
+}
+
+void crossing_counter::count_all( crossing_stats & stats ) {
+        std::vector< EdgeID > edge_crossings(m_source.size(), 0);
+        long num_cells = m_columns * m_rows;
+        double crossings = 0;
+
+        #pragma omp parallel for schedule(dynamic, 64) reduction(+:crossings)
+        for( long cell = 0; cell < num_cells; cell++) {
+                for( EdgeID i = m_cell_start[cell]; i < m_cell_start[cell + 1]; i++) {
+                        for( EdgeID j = i + 1; j < m_cell_start[cell + 1]; j++) {
+                                EdgeID lhs = m_cell_segments[i];
+                                EdgeID rhs = m_cell_segments[j];
+                                double x, y;
+                                if( !segments_cross(lhs, rhs, x, y) ) continue;
+                                if( cell_of_point(x, y) != cell ) continue;
+
+                                crossings += 1;
+                                __sync_fetch_and_add(&edge_crossings[lhs], 1);
+                                __sync_fetch_and_add(&edge_crossings[rhs], 1);
+                        }
+                }
+        }
+
+        stats.crossings          = crossings;
+        stats.max_edge_crossings = *std::max_element(edge_crossings.begin(), edge_crossings.end());
+        stats.evaluated_edges    = m_source.size();
+}
+
+void crossing_counter::count_sample( EdgeID sample_size, crossing_stats & stats ) {
+        // the sample is a prefix of a random permutation of the segments
+        std::vector< EdgeID > sample(m_source.size());
+        random_functions::permutate_vector_good(sample, true);
+
+        std::vector< EdgeID > edge_crossings(sample_size, 0);
+        long num_samples = sample_size;
+        #pragma omp parallel
+        {
+                std::vector< unsigned > cells;
+                #pragma omp for schedule(dynamic, 16)
+                for( long i = 0; i < num_samples; i++) {
+                        EdgeID segment = sample[i];
+                        segment_cells(segment, cells);
+                        for( unsigned c = 0; c < cells.size(); c++) {
+                                unsigned cell = cells[c];
+                                for( EdgeID j = m_cell_start[cell]; j < m_cell_start[cell + 1]; j++) {
+                                        double x, y;
+                                        if( !segments_cross(segment, m_cell_segments[j], x, y) ) continue;
+                                        if( cell_of_point(x, y) != cell ) continue;
+                                        edge_crossings[i]++;
+                                }
+                        }
+                }
+        }
+
+        // every crossing involves two edges
+        double mean = 0, variance = 0;
+        for( EdgeID i = 0; i < sample_size; i++) {
+                mean += edge_crossings[i];
+                stats.max_edge_crossings = std::max(stats.max_edge_crossings, edge_crossings[i]);
+        }
+        mean /= sample_size;
+        for( EdgeID i = 0; i < sample_size; i++) {
+                variance += (edge_crossings[i] - mean) * (edge_crossings[i] - mean);
+        }
+        if( sample_size > 1 ) variance /= sample_size - 1;
+
+        double num_segments      = m_source.size();
+        double finite_population = 1.0 - sample_size / num_segments;
+        stats.crossings       = num_segments * mean / 2;
+        stats.confidence      = 1.96 * num_segments / 2 * sqrt(variance * finite_population / sample_size);
+        stats.evaluated_edges = sample_size;
+}
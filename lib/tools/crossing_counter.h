@@ -0,0 +1,79 @@
+/******************************************************************************
+ * crossing_counter.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef CROSSING_COUNTER_W3JX8FPD
+#define CROSSING_COUNTER_W3JX8FPD
+
+#include <vector>
+
+#include "data_structure/graph_access.h"
+
+struct crossing_stats {
+        double crossings;          // (estimated) number of pairs of crossing edges
+        double confidence;         // half width of the 95% confidence interval, 0 if exact
+        double crossings_per_edge; // average number of crossings on an edge
+        EdgeID max_edge_crossings; // largest number of crossings on an edge (of the evaluated ones)
+        EdgeID evaluated_edges;    // number of edges whose crossings were counted
+};
+
+// Counts proper crossings of the straight line edges of a drawing (edges that share an endpoint, 
+// touch or overlap are not counted). The edges are inserted into a uniform grid of about one cell 
+// per edge, and each crossing is counted in the cell that contains the crossing point, so the cells 
+// can be processed independently.
+class crossing_counter {
+public:
+        crossing_counter();
+        virtual ~crossing_counter();
+
+        // exact if sample_size is 0 or at least the number of edges, otherwise the crossings of 
+        // sample_size random edges are counted and extrapolated
+        void count_crossings( graph_access & G, EdgeID sample_size, crossing_stats & stats );
+
+private:
+        void build_grid( graph_access & G );
+        void segment_cells( EdgeID segment, std::vector< unsigned > & cells );
+        unsigned cell_of_point( double x, double y );
+        bool segments_cross( EdgeID lhs, EdgeID rhs, double & x, double & y );
+
+        void count_all( crossing_stats & stats );
+        void count_sample( EdgeID sample_size, crossing_stats & stats );
+
+        // the undirected edges, source < target
+        std::vector< NodeID > m_source;
+        std::vector< NodeID > m_target;
+        std::vector< double > m_x;
+        std::vector< double > m_y;
+
+        double   m_x_min;
+        double   m_y_min;
+        double   m_cell_size;
+        unsigned m_columns;
+        unsigned m_rows;
+
+        // segments of cell c are m_cell_segments[m_cell_start[c]] ... m_cell_segments[m_cell_start[c+1]-1]
+        std::vector< EdgeID > m_cell_start;
+        std::vector< EdgeID > m_cell_segments;
+};
+
+
+#endif /* end of include guard: CROSSING_COUNTER_W3JX8FPD */
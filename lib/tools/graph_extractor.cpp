@@ -20,8 +20,10 @@
  *****************************************************************************/
 
 #include <unordered_map>
+
+#include "connected_components.h"
 #include "graph_extractor.h"
-#include "data_structure/union_find.h"
+#include "prefix_sum.h"
 
 graph_extractor::graph_extractor() {
 
@@ -33,35 +35,67 @@ graph_extractor::~graph_extractor() {
 
 void graph_extractor::extract_largest_component(graph_access & G, 
                                                 graph_access & Q) {
+        std::vector< NodeID > mapping;
+        extract_largest_component(G, Q, mapping);
+}
+
+void graph_extractor::extract_largest_component(graph_access & G, 
+                                                graph_access & Q,
+                                                std::vector<NodeID> & mapping) {
      
-        union_find uf(G.number_of_nodes());
-        forall_nodes(G, node) {
-                forall_out_edges(G, e, node) {
-                        NodeID target = G.getEdgeTarget(e);
-                        uf.Union(node,target);
-                } endfor
-        } endfor
+        std::vector< NodeID > component;
+        std::vector< NodeID > comp_size;
+        connected_components cc;
+        NodeID num_components = cc.compute_components(G, component, comp_size);
 
-        std::unordered_map<NodeID, NodeID> comp_size;
-        forall_nodes(G, node) {
-                comp_size[uf.Find(node)] += 1;
-                G.setPartitionIndex(node, uf.Find(node));
-        } endfor
-        
         NodeID max_size = 0;
         NodeID max_key  = 0;
-        for( auto it : comp_size ) {
-                //std::cout <<  it.first  << std::endl;
-                //std::cout <<  it.second << std::endl;
-
-                if( it.second > max_size ) {
-                        max_size = it.second;
-                        max_key = it.first;
+        for( NodeID c = 0; c < num_components; c++) {
+                if( comp_size[c] > max_size ) {
+                        max_size = comp_size[c];
+                        max_key  = c;
                 }
         }
 
-        std::vector< NodeID > mapping(G.number_of_nodes(), 0);
-        extract_block(G, Q, max_key, mapping);
+        long n = G.number_of_nodes();
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                G.setPartitionIndex(node, component[node]);
+        }
+
+        // new node ids and edge offsets are prefix sums over the nodes of the component. a component 
+        // is closed under adjacency, so its nodes keep all of their edges.
+        std::vector< NodeID > new_id(n);
+        std::vector< EdgeID > first_edge(n + 1, 0);
+        #pragma omp parallel for schedule(static)
+        for( long node = 0; node < n; node++) {
+                bool inside      = component[node] == max_key;
+                new_id[node]     = inside ? 1 : 0;
+                first_edge[node] = inside ? G.getNodeDegree(node) : 0;
+        }
+        NodeID nodes = parallel_prefix_sum(new_id);
+        EdgeID edges = parallel_prefix_sum(first_edge);
+
+        Q.start_construction(nodes, edges);
+        mapping.resize(nodes);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for( long node = 0; node < n; node++) {
+                if( component[node] != max_key ) continue;
+
+                NodeID new_node = new_id[node];
+                EdgeID new_edge = first_edge[node];
+                mapping[new_node] = node;
+                Q.setFirstEdge(new_node, new_edge);
+                Q.setNodeWeight(new_node, G.getNodeWeight(node));
+                Q.setCoords(new_node, G.getX(node), G.getY(node));
+
+                forall_out_edges(G, e, node) {
+                        Q.setEdgeTarget(new_edge, new_id[G.getEdgeTarget(e)]);
+                        Q.setEdgeWeight(new_edge, G.getEdgeWeight(e));
+                        new_edge++;
+                } endfor
+        }
+        Q.finish_parallel_construction();
 }
 
 
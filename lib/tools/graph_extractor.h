@@ -34,6 +34,11 @@ class graph_extractor {
                 void extract_largest_component(graph_access & G, 
                                                graph_access & Q );
 
+                // mapping[node] is the node of G that corresponds to node of Q
+                void extract_largest_component(graph_access & G, 
+                                               graph_access & Q,
+                                               std::vector<NodeID> & mapping);
+
                 void extract_block(graph_access & G, 
                                    graph_access & extracted_block, 
                                    PartitionID block, 
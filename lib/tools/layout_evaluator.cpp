@@ -0,0 +1,211 @@
+/******************************************************************************
+ * layout_evaluator.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdio.h>
+
+#include "layout_evaluator.h"
+#include "macros_assertions.h"
+#include "quality_metrics.h"
+#include "random_functions.h"
+#include "timer.h"
+
+layout_evaluator::layout_evaluator() {
+
+}
+
+layout_evaluator::~layout_evaluator() {
+
+}
+
+void layout_evaluator::evaluate( const Config & config, graph_access & G ) {
+        quality_metrics qm;
+        m_names.clear();
+        m_values.clear();
+
+        add_metric("nodes", G.number_of_nodes());
+        add_metric("edges", G.number_of_edges()/2);
+
+        // BFS pass. the FSM is taken at the optimal scaling factor, so both come from the same 
+        // sums and the coordinates do not have to be scaled before. large graphs are sampled.
+        timer t;
+        double scaling_factor = 1;
+        double fsm            = 0;
+        if( G.number_of_nodes() > config.sampled_stress_threshold ) {
+                stress_estimate estimate = qm.sampled_stress_measure_unit_weight(G, config.stress_target_error);
+                scaling_factor = estimate.scaling_factor;
+                fsm            = estimate.stress;
+                if( config.compute_FSM ) {
+                        add_metric("FSM", estimate.stress);
+                        add_metric("FSM_confidence", estimate.confidence);
+                        add_metric("FSM_sources", estimate.num_sources);
+                }
+        } else {
+                double top_fraction, bottom_fraction, num_pairs;
+                qm.full_stress_sums_unit_weight(G, top_fraction, bottom_fraction, num_pairs);
+                if( bottom_fraction > 0 ) {
+                        scaling_factor = top_fraction/bottom_fraction;
+                }
+                fsm = (num_pairs - top_fraction*scaling_factor)/2;
+                if( config.compute_FSM ) {
+                        add_metric("FSM", fsm);
+                }
+        }
+        add_metric("scaling_factor", scaling_factor);
+        add_metric("time_bfs_pass", t.elapsed());
+
+        // segment pass, on the coordinates as given
+        if( config.compute_crossings ) {
+                t.restart();
+                crossing_stats crossings;
+                qm.edge_crossings(G, config.crossing_samples, crossings);
+                add_metric("crossings", crossings.crossings);
+                if( crossings.evaluated_edges < G.number_of_edges()/2 ) {
+                        add_metric("crossings_confidence", crossings.confidence);
+                        add_metric("crossings_sampled_edges", crossings.evaluated_edges);
+                }
+                add_metric("crossings_per_edge", crossings.crossings_per_edge);
+                add_metric("max_crossings_per_edge", crossings.max_edge_crossings);
+                add_metric("time_segment_pass", t.elapsed());
+        }
+
+        // nearest neighbor pass
+        if( config.compute_neighborhood_preservation ) {
+                t.restart();
+                add_metric("neighborhood_preservation", qm.neighborhood_preservation(G));
+                add_metric("time_knn_pass", t.elapsed());
+        }
+
+        // the perturbation keeps coinciding nodes apart for the entropy term
+        forall_nodes(G, node) {
+                double rnd  = random_functions::nextDouble(1e-7,1e-4);
+                double rnd2 = random_functions::nextDouble(1e-7,1e-4);
+                G.setCoords(node, G.getX(node)*scaling_factor + rnd, G.getY(node)*scaling_factor + rnd2);
+        } endfor
+
+        // edge pass
+        t.restart();
+        edge_length_sums edge_sums;
+        qm.edge_sums_unit_weight(G, config.q, edge_sums);
+        double infeasibility = edge_sums.infeasibility/(double)G.number_of_edges();
+        add_metric("avg_infeasibility_per_edge", infeasibility);
+        add_metric("time_edge_pass", t.elapsed());
+
+        // pair pass
+        double ment = 0;
+        if( config.compute_MEnt ) {
+                t.restart();
+                double alpha       = 0.008;
+                double error_bound = 0;
+                double entropy     = 0;
+                if( G.number_of_nodes() > config.maxent_exact_threshold ) {
+                        entropy = qm.maxent_entropy_sum_approximate(G, config.q, config.maxent_theta, error_bound);
+                } else {
+                        entropy = qm.maxent_entropy_sum(G, config.q);
+                }
+
+                // the pair sum contains the edges but they do not belong to the entropy
+                entropy -= edge_sums.entropy;
+                if(abs(config.q) > 0.001) {
+                        entropy *= -sgn(config.q);
+                }
+
+                ment = (edge_sums.energy - alpha*entropy)/2;
+                add_metric("MEnt", ment);
+                add_metric("MEnt_error_bound", alpha*error_bound/2);
+                add_metric("MEnt_energy", edge_sums.energy);
+                add_metric("MEnt_entropy", entropy);
+                add_metric("time_pair_pass", t.elapsed());
+        }
+
+        for( unsigned i = 0; i < m_names.size(); i++) {
+                std::cout <<  m_names[i] << " " << std::setprecision(17) << m_values[i] << std::endl;
+        }
+
+        // the lines of the former evaluator output, scripts parse them
+        std::cout <<  "scaling factor is " << std::setprecision(6) << scaling_factor << std::endl;
+        if( config.compute_FSM ) {
+                std::cout <<  "FSM " << std::setprecision(200) << fsm << std::endl;
+        }
+        if( config.compute_MEnt ) {
+                std::cout <<  "MEnt " << std::setprecision(200) << ment << std::endl;
+                std::cout <<  "Avg. Invisibility per Edge "  << std::setprecision(200) << infeasibility << std::endl;
+        }
+}
+
+void layout_evaluator::add_metric( const std::string & name, double value ) {
+        m_names.push_back(name);
+        m_values.push_back(value);
+}
+
+bool layout_evaluator::write_report( const std::string & filename, const std::string & graph_filename ) {
+        FILE * out = fopen(filename.c_str(), "w");
+        if( out == NULL ) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return false;
+        }
+
+        bool csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+        bool ok  = csv ? write_csv(out, graph_filename) : write_json(out, graph_filename);
+        if( fclose(out) != 0 ) {
+                ok = false;
+        }
+        if( !ok ) {
+                std::cerr << "Error writing " << filename << std::endl;
+        }
+        return ok;
+}
+
+bool layout_evaluator::write_json( FILE * out, const std::string & graph_filename ) {
+        fprintf(out, "{\n  \"graph\": \"");
+        for( unsigned i = 0; i < graph_filename.size(); i++) {
+                char c = graph_filename[i];
+                if( c == '"' || c == '\\' ) fputc('\\', out);
+                fputc(c, out);
+        }
+        fprintf(out, "\"");
+        for( unsigned i = 0; i < m_names.size(); i++) {
+                // JSON has no representation of nan and inf
+                if( std::isfinite(m_values[i]) ) {
+                        fprintf(out, ",\n  \"%s\": %.17g", m_names[i].c_str(), m_values[i]);
+                } else {
+                        fprintf(out, ",\n  \"%s\": null", m_names[i].c_str());
+                }
+        }
+        fprintf(out, "\n}\n");
+        return !ferror(out);
+}
+
+bool layout_evaluator::write_csv( FILE * out, const std::string & graph_filename ) {
+        fprintf(out, "graph");
+        for( unsigned i = 0; i < m_names.size(); i++) {
+                fprintf(out, ",%s", m_names[i].c_str());
+        }
+        fprintf(out, "\n\"%s\"", graph_filename.c_str());
+        for( unsigned i = 0; i < m_values.size(); i++) {
+                fprintf(out, ",%.17g", m_values[i]);
+        }
+        fprintf(out, "\n");
+        return !ferror(out);
+}
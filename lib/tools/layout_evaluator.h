@@ -0,0 +1,59 @@
+/******************************************************************************
+ * layout_evaluator.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef LAYOUT_EVALUATOR_T5NC2KQW
+#define LAYOUT_EVALUATOR_T5NC2KQW
+
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "data_structure/graph_access.h"
+
+// Computes the requested layout metrics in as few passes over the graph as possible: 
+// one BFS pass (scaling factor and full stress), one pass over a grid of the edges (crossings),
+// one pass of nearest neighbor queries (neighborhood preservation), one edge pass (energy, edge entropy and infeasibility) and one pass over all pairs (entropy of 
+// MaxEnt-stress). Each pass is parallel.
+// The results are printed and collected in a report that can be written as JSON or CSV.
+class layout_evaluator {
+public:
+        layout_evaluator();
+        virtual ~layout_evaluator();
+
+        // scales the coordinates of G by the optimal FSM scaling factor and perturbs them slightly
+        void evaluate( const Config & config, graph_access & G );
+
+        // CSV if the filename ends with .csv, JSON otherwise. false if the file could not be written
+        bool write_report( const std::string & filename, const std::string & graph_filename );
+
+private:
+        void add_metric( const std::string & name, double value );
+        bool write_json( FILE * out, const std::string & graph_filename );
+        bool write_csv( FILE * out, const std::string & graph_filename );
+
+        std::vector< std::string > m_names;
+        std::vector< double >      m_values;
+};
+
+
+#endif /* end of include guard: LAYOUT_EVALUATOR_T5NC2KQW */
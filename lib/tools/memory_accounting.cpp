@@ -0,0 +1,214 @@
+/******************************************************************************
+ * memory_accounting.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "memory_accounting.h"
+
+bool memory_accounting::m_enabled = false;
+std::mutex memory_accounting::m_mutex;
+std::map< std::pair< std::string, int >, memory_record > memory_accounting::m_records;
+std::vector< memory_phase > memory_accounting::m_phases;
+
+void memory_accounting::enable() {
+        m_enabled = true;
+}
+
+void memory_accounting::record( const char * structure, int level, NodeID nodes, EdgeID edges, 
+                                size_t node_bytes, size_t edge_bytes, memory_lifetime lifetime ) {
+        if( !m_enabled ) return;
+
+        std::lock_guard< std::mutex > lock(m_mutex);
+        std::pair< std::string, int > key(structure, level);
+        if( m_records.find(key) == m_records.end() ) {
+                memory_record record;
+                record.nodes      = 0;
+                record.edges      = 0;
+                record.node_bytes = 0;
+                record.edge_bytes = 0;
+                record.lifetime   = lifetime;
+                m_records[key]    = record;
+        }
+
+        memory_record & record = m_records[key];
+        record.nodes      = std::max(record.nodes, nodes);
+        record.edges      = std::max(record.edges, edges);
+        record.node_bytes = std::max(record.node_bytes, node_bytes);
+        record.edge_bytes = std::max(record.edge_bytes, edge_bytes);
+}
+
+void memory_accounting::record_graph( const char * structure, int level, graph_access & G ) {
+        if( !m_enabled ) return;
+
+        // sizes of the arrays allocated by basicGraph::start_construction
+        NodeID n = G.number_of_nodes();
+        EdgeID m = G.number_of_edges();
+        size_t node_bytes = (n + 1) * (sizeof(Node) + sizeof(refinementNode)) + n * sizeof(otherNodeProp);
+        size_t edge_bytes = m * (sizeof(Edge) + sizeof(otherEdgeProp));
+        record(structure, level, n, m, node_bytes, edge_bytes, MEMORY_PERSISTENT);
+}
+
+void memory_accounting::record_phase( const char * name ) {
+        if( !m_enabled ) return;
+
+        memory_phase phase;
+        phase.name     = name;
+        phase.rss      = current_rss();
+        phase.peak_rss = std::max(peak_rss(), phase.rss);
+
+        std::lock_guard< std::mutex > lock(m_mutex);
+        for( unsigned i = 0; i < m_phases.size(); i++) {
+                if( m_phases[i].name == phase.name ) {
+                        m_phases[i].rss      = std::max(m_phases[i].rss, phase.rss);
+                        m_phases[i].peak_rss = std::max(m_phases[i].peak_rss, phase.peak_rss);
+                        return;
+                }
+        }
+        m_phases.push_back(phase);
+}
+
+size_t memory_accounting::current_rss() {
+        FILE * statm = fopen("/proc/self/statm", "r");
+        if( statm == NULL ) return 0;
+
+        long size = 0, resident = 0;
+        int read = fscanf(statm, "%ld %ld", &size, &resident);
+        fclose(statm);
+        if( read != 2 ) return 0;
+        return (size_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+size_t memory_accounting::peak_rss() {
+        struct rusage usage;
+        if( getrusage(RUSAGE_SELF, &usage) != 0 ) return 0;
+        return (size_t)usage.ru_maxrss * 1024; // kilobytes on linux
+}
+
+static double megabytes( double bytes ) {
+        return bytes / (1024.0 * 1024.0);
+}
+
+void memory_accounting::print_report( NodeID n, EdgeID m ) {
+        std::lock_guard< std::mutex > lock(m_mutex);
+
+        // one row per level, one column per structure
+        std::vector< std::string > structures;
+        int levels = 0;
+        for( auto it = m_records.begin(); it != m_records.end(); ++it) {
+                if( std::find(structures.begin(), structures.end(), it->first.first) == structures.end() ) {
+                        structures.push_back(it->first.first);
+                }
+                levels = std::max(levels, it->first.second + 1);
+        }
+
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision     = std::cout.precision();
+        std::cout <<  std::fixed << std::setprecision(2);
+
+        std::cout <<  "memory per level [MB]" << std::endl;
+        std::cout <<  std::setw(6) << "level" << std::setw(12) << "nodes" << std::setw(14) << "edges";
+        for( unsigned s = 0; s < structures.size(); s++) {
+                std::cout << std::setw(std::max(12, (int)structures[s].size() + 2)) << structures[s];
+        }
+        std::cout <<  std::endl;
+
+        size_t persistent_node_bytes = 0;
+        size_t persistent_edge_bytes = 0;
+        size_t temporary_node_bytes  = 0;
+        size_t temporary_edge_bytes  = 0;
+        for( int level = 0; level < levels; level++) {
+                NodeID nodes = 0;
+                EdgeID edges = 0;
+                size_t level_temporary_node_bytes = 0;
+                size_t level_temporary_edge_bytes = 0;
+                std::ostringstream row;
+                row <<  std::fixed << std::setprecision(2);
+                for( unsigned s = 0; s < structures.size(); s++) {
+                        int width = std::max(12, (int)structures[s].size() + 2);
+                        auto it   = m_records.find(std::make_pair(structures[s], level));
+                        if( it == m_records.end() ) {
+                                row << std::setw(width) << "-";
+                                continue;
+                        }
+
+                        memory_record & record = it->second;
+                        nodes = std::max(nodes, record.nodes);
+                        edges = std::max(edges, record.edges);
+                        row << std::setw(width) << megabytes(record.node_bytes + record.edge_bytes);
+                        if( record.lifetime == MEMORY_PERSISTENT ) {
+                                persistent_node_bytes += record.node_bytes;
+                                persistent_edge_bytes += record.edge_bytes;
+                        } else {
+                                level_temporary_node_bytes += record.node_bytes;
+                                level_temporary_edge_bytes += record.edge_bytes;
+                        }
+                }
+                // only the temporary structures of one level exist at a time (upper bound, 
+                // the ones of coarsening and uncoarsening do not coexist either)
+                if( level_temporary_node_bytes + level_temporary_edge_bytes > temporary_node_bytes + temporary_edge_bytes ) {
+                        temporary_node_bytes = level_temporary_node_bytes;
+                        temporary_edge_bytes = level_temporary_edge_bytes;
+                }
+                std::cout <<  std::setw(6) << level << std::setw(12) << nodes << std::setw(14) << edges/2 << row.str() << std::endl;
+        }
+
+        size_t accounted = persistent_node_bytes + persistent_edge_bytes + temporary_node_bytes + temporary_edge_bytes;
+        std::cout <<  "persistent structures " << megabytes(persistent_node_bytes + persistent_edge_bytes) << " MB"
+                  <<  ", largest temporary structures of one level " << megabytes(temporary_node_bytes + temporary_edge_bytes) << " MB"
+                  <<  ", accounted peak " << megabytes(accounted) << " MB" << std::endl;
+
+        std::cout <<  "resident set size per phase [MB]" << std::endl;
+        std::cout <<  std::left << std::setw(36) << "phase" << std::right << std::setw(12) << "rss" << std::setw(12) << "peak rss" << std::endl;
+        for( unsigned i = 0; i < m_phases.size(); i++) {
+                std::cout <<  std::left << std::setw(36) << m_phases[i].name << std::right 
+                          <<  std::setw(12) << megabytes(m_phases[i].rss) << std::setw(12) << megabytes(m_phases[i].peak_rss) << std::endl;
+        }
+
+        // bytes per node and edge of the input, the measured peak calibrates allocator 
+        // overhead and everything that is not accounted
+        double bytes_per_node = n > 0 ? (double)(persistent_node_bytes + temporary_node_bytes) / n : 0;
+        double bytes_per_edge = m > 0 ? (double)(persistent_edge_bytes + temporary_edge_bytes) / m : 0;
+        double baseline       = m_phases.empty() ? 0 : m_phases[0].rss;
+        double peak           = std::max(peak_rss(), current_rss());
+        double overhead       = 1;
+        if( accounted > 0 && peak > baseline ) {
+                overhead = (peak - baseline) / accounted;
+        }
+
+        std::cout <<  std::setprecision(1);
+        std::cout <<  "accounted " << bytes_per_node << " bytes per node and " << bytes_per_edge << " bytes per edge"
+                  <<  ", measured peak rss " << std::setprecision(2) << megabytes(peak) << " MB"
+                  <<  " (baseline " << megabytes(baseline) << " MB, overhead factor " << overhead << ")" << std::endl;
+        std::cout <<  std::setprecision(0);
+        std::cout <<  "predicted peak rss for a graph with n nodes and m edges: " 
+                  <<  baseline << " + " << overhead * bytes_per_node << " * n + " << overhead * bytes_per_edge << " * m bytes" << std::endl;
+
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+}
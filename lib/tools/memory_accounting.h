@@ -0,0 +1,87 @@
+/******************************************************************************
+ * memory_accounting.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+
+#ifndef MEMORY_ACCOUNTING_P8JV2DKC
+#define MEMORY_ACCOUNTING_P8JV2DKC
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "data_structure/graph_access.h"
+
+enum memory_lifetime { MEMORY_PERSISTENT, MEMORY_TEMPORARY };
+
+struct memory_record {
+        NodeID nodes;       // size of the graph the structure belongs to
+        EdgeID edges;       // directed edges
+        size_t node_bytes;  // part of the structure that grows with the nodes
+        size_t edge_bytes;  // part of the structure that grows with the edges
+        memory_lifetime lifetime;
+};
+
+struct memory_phase {
+        std::string name;
+        size_t rss;
+        size_t peak_rss;
+};
+
+// Accounts the bytes of the graph hierarchy and of the optimizer buffers per level (0 is
+// the finest level) and the resident set size of the process after each phase. Persistent 
+// structures (graphs, mappings) live as long as the hierarchy, temporary ones (optimizer 
+// buffers) only during one level. From both and the peak RSS of the run a linear model 
+// of the footprint in the number of nodes and edges is derived. If a structure is recorded 
+// more than once on the same level, e.g. for several components, the maximum is kept. 
+// As long as the accounting is not enabled, recording costs a single branch.
+class memory_accounting {
+public:
+        static void enable();
+        static bool enabled() { return m_enabled; }
+
+        static void record( const char * structure, int level, NodeID nodes, EdgeID edges, 
+                            size_t node_bytes, size_t edge_bytes, memory_lifetime lifetime );
+
+        // records the node and edge arrays of G
+        static void record_graph( const char * structure, int level, graph_access & G );
+
+        // remembers the current and the peak resident set size of the process
+        static void record_phase( const char * name );
+
+        // in bytes, 0 if not available
+        static size_t current_rss();
+        static size_t peak_rss();
+
+        // n and m are the nodes and (undirected) edges of the input graph
+        static void print_report( NodeID n, EdgeID m );
+
+private:
+        static bool m_enabled;
+        static std::mutex m_mutex;
+        static std::map< std::pair< std::string, int >, memory_record > m_records;
+        static std::vector< memory_phase > m_phases;
+};
+
+
+#endif /* end of include guard: MEMORY_ACCOUNTING_P8JV2DKC */
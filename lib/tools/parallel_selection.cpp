@@ -0,0 +1,131 @@
+/******************************************************************************
+ * parallel_selection.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <omp.h>
+
+#include "parallel_selection.h"
+
+parallel_selection::parallel_selection() {
+
+}
+
+parallel_selection::~parallel_selection() {
+
+}
+
+void parallel_selection::select( const std::vector< double > & values, 
+                                 const std::vector< EdgeID > & ranks, 
+                                 std::vector< double > & result ) {
+        long n = values.size();
+        result.assign(ranks.size(), 0);
+        if( n == 0 ) return;
+
+        double min_value = values[0];
+        double max_value = values[0];
+        #pragma omp parallel for reduction(min:min_value) reduction(max:max_value)
+        for( long i = 0; i < n; i++) {
+                min_value = std::min(min_value, values[i]);
+                max_value = std::max(max_value, values[i]);
+        }
+        if( min_value == max_value ) {
+                result.assign(ranks.size(), min_value);
+                return;
+        }
+
+        const double factor = SELECTION_HISTOGRAM_BINS / (max_value - min_value);
+        #define VALUE_BIN(v) std::min(SELECTION_HISTOGRAM_BINS - 1, (unsigned)(((v) - min_value) * factor))
+
+        // every thread counts into its own histogram
+        int num_threads = omp_get_max_threads();
+        std::vector< std::vector< EdgeID > > local_histogram(num_threads);
+        #pragma omp parallel
+        {
+                std::vector< EdgeID > & histogram = local_histogram[omp_get_thread_num()];
+                histogram.assign(SELECTION_HISTOGRAM_BINS, 0);
+                #pragma omp for schedule(static)
+                for( long i = 0; i < n; i++) {
+                        histogram[VALUE_BIN(values[i])]++;
+                }
+        }
+
+        // bin_start[b] is the rank of the first value in bin b
+        std::vector< EdgeID > bin_start(SELECTION_HISTOGRAM_BINS + 1, 0);
+        for( unsigned bin = 0; bin < SELECTION_HISTOGRAM_BINS; bin++) {
+                EdgeID count = 0;
+                for( int thread = 0; thread < num_threads; thread++) {
+                        count += local_histogram[thread][bin];
+                }
+                bin_start[bin+1] = bin_start[bin] + count;
+        }
+
+        // bins that contain a requested rank, each gets a slot for its candidates
+        std::vector< int > bin_slot(SELECTION_HISTOGRAM_BINS, -1);
+        std::vector< unsigned > slot_bin;
+        std::vector< unsigned > rank_bin(ranks.size());
+        for( unsigned i = 0; i < ranks.size(); i++) {
+                EdgeID rank = std::min((EdgeID)(n - 1), ranks[i]);
+                unsigned bin = std::upper_bound(bin_start.begin(), bin_start.end(), rank) - bin_start.begin() - 1;
+                rank_bin[i] = bin;
+                if( bin_slot[bin] == -1 ) {
+                        bin_slot[bin] = slot_bin.size();
+                        slot_bin.push_back(bin);
+                }
+        }
+
+        std::vector< std::vector< std::vector< double > > > local_candidates(num_threads, 
+                                                                         std::vector< std::vector< double > >(slot_bin.size()));
+        #pragma omp parallel for schedule(static)
+        for( long i = 0; i < n; i++) {
+                int slot = bin_slot[VALUE_BIN(values[i])];
+                if( slot != -1 ) {
+                        local_candidates[omp_get_thread_num()][slot].push_back(values[i]);
+                }
+        }
+        #undef VALUE_BIN
+
+        std::vector< std::vector< double > > candidates(slot_bin.size());
+        for( unsigned slot = 0; slot < slot_bin.size(); slot++) {
+                for( int thread = 0; thread < num_threads; thread++) {
+                        candidates[slot].insert(candidates[slot].end(), local_candidates[thread][slot].begin(), local_candidates[thread][slot].end());
+                }
+        }
+
+        for( unsigned i = 0; i < ranks.size(); i++) {
+                EdgeID rank = std::min((EdgeID)(n - 1), ranks[i]);
+                std::vector< double > & bin_values = candidates[bin_slot[rank_bin[i]]];
+                std::vector< double >::iterator nth = bin_values.begin() + (rank - bin_start[rank_bin[i]]);
+                std::nth_element(bin_values.begin(), nth, bin_values.end());
+                result[i] = *nth;
+        }
+}
+
+double parallel_selection::median( const std::vector< double > & values ) {
+        if( values.size() == 0 ) return 0;
+
+        std::vector< EdgeID > ranks;
+        ranks.push_back((values.size() - 1) / 2);
+        ranks.push_back(values.size() / 2);
+
+        std::vector< double > result;
+        select(values, ranks, result);
+        return (result[0] + result[1]) / 2;
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * parallel_selection.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef PARALLEL_SELECTION_X8VQ2MTB
+#define PARALLEL_SELECTION_X8VQ2MTB
+
+#include <vector>
+
+#include "definitions.h"
+
+// number of value ranges of the histogram that locates the requested ranks
+const unsigned SELECTION_HISTOGRAM_BINS = 1 << 14;
+
+// Exact parallel selection of several order statistics at once without sorting.
+// A parallel histogram over the value range determines the bin of every requested
+// rank, only the few values inside these bins are then selected with nth_element.
+class parallel_selection {
+        public:
+                parallel_selection();
+                virtual ~parallel_selection();
+
+                // result[i] is the value of rank ranks[i] (0-based) in the sorted sequence of values
+                void select( const std::vector< double > & values, 
+                             const std::vector< EdgeID > & ranks, 
+                             std::vector< double > & result );
+
+                // median as the mean of the two middle elements for even sizes
+                double median( const std::vector< double > & values );
+};
+
+
+#endif /* end of include guard: PARALLEL_SELECTION_X8VQ2MTB */
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * perf_counters.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#include "perf_counters.h"
+
+int perf_counters::m_fd[NUM_PERF_COUNTERS] = { -1, -1, -1, -1 };
+bool perf_counters::m_available = false;
+std::string perf_counters::m_error = "not opened";
+
+bool perf_counters::open() {
+        close();
+#if defined(__linux__) && defined(__NR_perf_event_open)
+        const unsigned long long events[NUM_PERF_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES, 
+                                                               PERF_COUNT_HW_INSTRUCTIONS,
+                                                               PERF_COUNT_HW_CACHE_MISSES, 
+                                                               PERF_COUNT_HW_BRANCH_MISSES };
+        for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size           = sizeof(attr);
+                attr.type           = PERF_TYPE_HARDWARE;
+                attr.config         = events[counter];
+                attr.inherit        = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv     = 1;
+                attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                m_fd[counter] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                if( m_fd[counter] >= 0 ) {
+                        m_available = true;
+                } else {
+                        m_error = strerror(errno);
+                }
+        }
+#else
+        m_error = "perf_event_open is not supported on this system";
+#endif
+        return m_available;
+}
+
+void perf_counters::close() {
+        for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                if( m_fd[counter] >= 0 ) ::close(m_fd[counter]);
+                m_fd[counter] = -1;
+        }
+        m_available = false;
+}
+
+const char * perf_counters::counter_name( int counter ) {
+        switch( counter ) {
+                case PERF_CYCLES:        return "cycles";
+                case PERF_INSTRUCTIONS:  return "instructions";
+                case PERF_LLC_MISSES:    return "llc_misses";
+                case PERF_BRANCH_MISSES: return "branch_misses";
+        }
+        return "";
+}
+
+void perf_counters::read( perf_sample & sample ) {
+        for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                sample.value[counter] = -1;
+                if( m_fd[counter] < 0 ) continue;
+
+                // value, time enabled, time running
+                unsigned long long data[3];
+                if( ::read(m_fd[counter], data, sizeof(data)) != sizeof(data) ) continue;
+
+                if( data[2] > 0 && data[2] < data[1] ) {
+                        sample.value[counter] = (long long)((double)data[0] * data[1] / data[2]);
+                } else {
+                        sample.value[counter] = data[0];
+                }
+        }
+}
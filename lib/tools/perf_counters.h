@@ -0,0 +1,60 @@
+/******************************************************************************
+ * perf_counters.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef PERF_COUNTERS_R4TX8MUB
+#define PERF_COUNTERS_R4TX8MUB
+
+#include <string>
+
+const int NUM_PERF_COUNTERS = 4;
+enum perf_counter_type { PERF_CYCLES = 0, PERF_INSTRUCTIONS = 1, PERF_LLC_MISSES = 2, PERF_BRANCH_MISSES = 3 };
+
+struct perf_sample {
+        long long value[NUM_PERF_COUNTERS]; // -1 if the counter is not available
+};
+
+// Hardware counters of the whole process via perf_event_open. The counters are inherited by all 
+// threads that are created after open() (e.g. the OpenMP thread pool), and a read returns the sum 
+// over all threads. Counters that the kernel refuses (no permission, not supported in a virtual 
+// machine or container) are reported as unavailable.
+class perf_counters {
+public:
+        // returns false if no counter could be opened, error() tells why
+        static bool open();
+        static void close();
+
+        static bool available() { return m_available; }
+        static bool counter_available( int counter ) { return m_fd[counter] >= 0; }
+        static const char * counter_name( int counter );
+        static const std::string & error() { return m_error; }
+
+        // values are scaled up if the kernel had to multiplex the counters
+        static void read( perf_sample & sample );
+
+private:
+        static int m_fd[NUM_PERF_COUNTERS];
+        static bool m_available;
+        static std::string m_error;
+};
+
+
+#endif /* end of include guard: PERF_COUNTERS_R4TX8MUB */
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * prefix_sum.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef PREFIX_SUM_Q8MTZ3VC
+#define PREFIX_SUM_Q8MTZ3VC
+
+#include <omp.h>
+#include <vector>
+
+// below this size the prefix sum is computed sequentially
+const long PARALLEL_PREFIX_SUM_SIZE = 1 << 16;
+
+// Replaces values by their exclusive prefix sum and returns the total.
+// Every thread sums a contiguous chunk, the chunk offsets are summed sequentially
+// and the chunks are then rewritten in parallel.
+template < typename sometype >
+sometype parallel_prefix_sum( std::vector< sometype > & values ) {
+        long n = values.size();
+        if( n < PARALLEL_PREFIX_SUM_SIZE || omp_get_max_threads() == 1 ) {
+                sometype sum = 0;
+                for( long i = 0; i < n; i++) {
+                        sometype value = values[i];
+                        values[i] = sum;
+                        sum += value;
+                }
+                return sum;
+        }
+
+        std::vector< sometype > chunk_sum(omp_get_max_threads() + 1, 0);
+        int used_threads = 1;
+        #pragma omp parallel
+        {
+                int  num_threads = omp_get_num_threads();
+                int  thread      = omp_get_thread_num();
+                long begin       = n * thread / num_threads;
+                long end         = n * (thread + 1) / num_threads;
+
+                sometype sum = 0;
+                for( long i = begin; i < end; i++) {
+                        sum += values[i];
+                }
+                chunk_sum[thread + 1] = sum;
+
+                #pragma omp barrier
+                #pragma omp single
+                {
+                        used_threads = num_threads;
+                        for( int i = 0; i < num_threads; i++) {
+                                chunk_sum[i + 1] += chunk_sum[i];
+                        }
+                }
+
+                sum = chunk_sum[thread];
+                for( long i = begin; i < end; i++) {
+                        sometype value = values[i];
+                        values[i] = sum;
+                        sum += value;
+                }
+        }
+        return chunk_sum[used_threads];
+}
+
+
+#endif /* end of include guard: PREFIX_SUM_Q8MTZ3VC */
@@ -20,11 +20,16 @@
  *****************************************************************************/
 
 
+#include <algorithm>
 #include <iomanip>
+#include <omp.h>
+
 #include "algorithms/shortest_paths.h"
+#include "data_structure/kd_tree.h"
 #include "quality_metrics.h"
+#include "random_functions.h"
 
-quality_metrics::quality_metrics() {
+quality_metrics::quality_metrics() : m_num_threads(0) {
 
 }
 
@@ -44,48 +49,22 @@ void quality_metrics::print_distances( graph_access & G) {
         } endfor
 }
 
-double quality_metrics::maxent_unitweight( graph_access & G, double q, double alpha, std::string prefix ) {
-        double energy  = 0;
-        double entropy = 0;
-
-        forall_nodes_parallel_reduce(G, source, +, entropy) {
-                forall_nodes(G, target) {
-                        if(source == target) continue;
-
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
-
-                        if(abs(q) < 0.001) {
-                                entropy += log(dist);
-                        } else {
-                                entropy += pow(dist,-q);
-                        }
-                } endfor
-        } endfor
-
-        forall_nodes(G, source) {
-                forall_out_edges(G, e, source) {
-                        NodeID target = G.getEdgeTarget(e);
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
-
-                        int best_distance = 1;
-                        energy += (dist - best_distance)*(dist - best_distance)/(best_distance*best_distance);
-
-                        // we added those in the previous iteration but they do not belong here
-                        if(abs(q) < 0.001) {
-                                entropy -= log(dist);
-                        } else {
-                                entropy -= pow(dist,-q);
-                        }
+// one summand of the entropy term, log(dist) if use_log and dist^-q otherwise
+static inline double entropy_term( double dist_square, double q, bool use_log ) {
+        if( use_log ) {
+                return 0.5 * log(dist_square);
+        } 
+        return pow(dist_square, -0.5 * q);
+}
 
-                } endfor
-        } endfor
+double quality_metrics::maxent_unitweight( graph_access & G, double q, double alpha, std::string prefix ) {
+        edge_length_sums edge_sums;
+        edge_sums_unit_weight(G, q, edge_sums);
+        double energy       = edge_sums.energy;
+        double edge_entropy = edge_sums.entropy;
 
+        // we added the edges in the entropy sum but they do not belong there
+        double entropy = maxent_entropy_sum(G, q) - edge_entropy;
         if(abs(q) > 0.001) {
                entropy *= -sgn(q);
         }
@@ -102,124 +81,475 @@ double quality_metrics::maxent_unitweight( graph_access & G, double q, double al
 
 
 double quality_metrics::maxent_unitweight( graph_access & G, double q, double alpha ) {
-        double energy  = 0;
-        double entropy = 0;
-
-        forall_nodes_parallel_reduce(G, source, +, entropy) {
-                forall_nodes(G, target) {
-                        if(source == target) continue;
-
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
-
-                        if(abs(q) < 0.001) {
-                                entropy += log(dist);
-                        } else {
-                                entropy += pow(dist,-q);
-                        }
-                } endfor
-        } endfor
+        edge_length_sums edge_sums;
+        edge_sums_unit_weight(G, q, edge_sums);
+        double energy       = edge_sums.energy;
+        double edge_entropy = edge_sums.entropy;
 
-        forall_nodes(G, source) {
-                forall_out_edges(G, e, source) {
-                        NodeID target = G.getEdgeTarget(e);
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
+        // we added the edges in the entropy sum but they do not belong there
+        double entropy = maxent_entropy_sum(G, q) - edge_entropy;
+        if(abs(q) > 0.001) {
+               entropy *= -sgn(q);
+        }
 
-                        int best_distance = 1;
-                        energy += (dist - best_distance)*(dist - best_distance)/(best_distance*best_distance);
+        std::cout <<  "sgn(q="<<q<<") is " << sgn(q) << std::endl;
+        std::cout <<  "energy is " <<  energy << std::endl;
+        std::cout <<  "entropy is " <<  entropy  << std::endl;
+        std::cout <<  "alpha*entropy is " <<  alpha*entropy  << std::endl;
+        std::cout <<  "alpha is " << std::setprecision(4) <<  alpha  << std::endl;
 
-                        // we added those in the previous iteration but they do not belong here
-                        if(abs(q) < 0.001) {
-                                entropy -= log(dist);
-                        } else {
-                                entropy -= pow(dist,-q);
-                        }
+        energy -= alpha*entropy;
+        return energy/2;
+}
 
-                } endfor
-        } endfor
+double quality_metrics::maxent_unitweight_approximate( graph_access & G, double q, double alpha, double theta, double & error_bound ) {
+        edge_length_sums edge_sums;
+        edge_sums_unit_weight(G, q, edge_sums);
+        double energy       = edge_sums.energy;
+        double edge_entropy = edge_sums.entropy;
 
+        double entropy_error = 0;
+        double entropy = maxent_entropy_sum_approximate(G, q, theta, entropy_error) - edge_entropy;
         if(abs(q) > 0.001) {
                entropy *= -sgn(q);
         }
 
         std::cout <<  "sgn(q="<<q<<") is " << sgn(q) << std::endl;
         std::cout <<  "energy is " <<  energy << std::endl;
-        std::cout <<  "entropy is " <<  entropy  << std::endl;
+        std::cout <<  "entropy is " <<  entropy  << " +- " << entropy_error << std::endl;
         std::cout <<  "alpha*entropy is " <<  alpha*entropy  << std::endl;
         std::cout <<  "alpha is " << std::setprecision(4) <<  alpha  << std::endl;
 
-        energy -= alpha*entropy;
+        energy     -= alpha*entropy;
+        error_bound = fabs(alpha)*entropy_error/2;
         return energy/2;
 }
 
-double quality_metrics::full_stress_measure_unit_weight( graph_access & G ) {
-        double energy = 0;
-        double scaling_factor = compute_fsm_scaling_factor_unit_weight(G);
-        std::cout <<  "scaling factor is " << scaling_factor  << std::endl;
-        forall_nodes_parallel_reduce(G, source,+,energy) {
-	        shortest_paths sp;
-	        std::vector<int> deepth(G.number_of_nodes(), -1);
-                sp.one_to_many_unit_weight(G, source, deepth);
+void quality_metrics::edge_sums_unit_weight( graph_access & G, double q, edge_length_sums & sums ) {
+        bool use_log         = abs(q) < 0.001;
+        double energy        = 0;
+        double entropy       = 0;
+        double infeasibility = 0;
 
-                forall_nodes(G, target) {
+        NodeID num_nodes = G.number_of_nodes();
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:energy,entropy,infeasibility)
+        for( NodeID source = 0; source < num_nodes; source++) {
+                forall_out_edges(G, e, source) {
+                        NodeID target = G.getEdgeTarget(e);
                         double diffX       = G.getX(source) - G.getX(target);
                         double diffY       = G.getY(source) - G.getY(target);
                         double dist_square = diffX*diffX+diffY*diffY;
                         double dist        = sqrt(dist_square);
 
-                        int best_distance = deepth[target];
-                        if( best_distance == 0 ) continue;
-                        energy += (scaling_factor*dist - best_distance)*(scaling_factor*dist - best_distance)/(best_distance*best_distance);
+                        int best_distance = 1;
+                        energy        += (dist - best_distance)*(dist - best_distance)/(best_distance*best_distance);
+                        entropy       += entropy_term(dist_square, q, use_log);
+                        infeasibility += fabs(1.0-dist);
                 } endfor
+        }
+
+        sums.energy        = energy;
+        sums.entropy       = entropy;
+        sums.infeasibility = infeasibility;
+}
+
+double quality_metrics::maxent_entropy_sum( graph_access & G, double q ) {
+        bool use_log     = abs(q) < 0.001;
+        NodeID num_nodes = G.number_of_nodes();
+
+        std::vector< double > x(num_nodes);
+        std::vector< double > y(num_nodes);
+        forall_nodes(G, node) {
+                x[node] = G.getX(node);
+                y[node] = G.getY(node);
         } endfor
 
-        return energy/2;
+        // the targets are processed in tiles that stay in cache while a block of sources 
+        // runs over them, the inner loops are free of branches so that they vectorize
+        const NodeID tile_size = 4096;
+        long num_tiles = (num_nodes + tile_size - 1) / tile_size;
+        double entropy = 0;
+
+        #pragma omp parallel for schedule(dynamic, 1) reduction(+:entropy)
+        for( long tile = 0; tile < num_tiles * num_tiles; tile++) {
+                NodeID source_begin = (tile / num_tiles) * tile_size;
+                NodeID source_end   = std::min(num_nodes, source_begin + tile_size);
+                NodeID target_begin = (tile % num_tiles) * tile_size;
+                NodeID target_end   = std::min(num_nodes, target_begin + tile_size);
+
+                for( NodeID source = source_begin; source < source_end; source++) {
+                        double source_x = x[source];
+                        double source_y = y[source];
+
+                        // the source itself is skipped by splitting the range
+                        NodeID self = std::min(std::max(source, target_begin), target_end);
+                        NodeID skip = source >= target_begin && source < target_end ? 1 : 0;
+
+                        double sum = 0;
+                        if( use_log ) {
+                                #pragma omp simd reduction(+:sum)
+                                for( NodeID target = target_begin; target < self; target++) {
+                                        double diffX = source_x - x[target];
+                                        double diffY = source_y - y[target];
+                                        sum += 0.5 * log(diffX*diffX+diffY*diffY);
+                                }
+                                #pragma omp simd reduction(+:sum)
+                                for( NodeID target = self + skip; target < target_end; target++) {
+                                        double diffX = source_x - x[target];
+                                        double diffY = source_y - y[target];
+                                        sum += 0.5 * log(diffX*diffX+diffY*diffY);
+                                }
+                        } else {
+                                double exponent = -0.5 * q;
+                                #pragma omp simd reduction(+:sum)
+                                for( NodeID target = target_begin; target < self; target++) {
+                                        double diffX = source_x - x[target];
+                                        double diffY = source_y - y[target];
+                                        sum += pow(diffX*diffX+diffY*diffY, exponent);
+                                }
+                                #pragma omp simd reduction(+:sum)
+                                for( NodeID target = self + skip; target < target_end; target++) {
+                                        double diffX = source_x - x[target];
+                                        double diffY = source_y - y[target];
+                                        sum += pow(diffX*diffX+diffY*diffY, exponent);
+                                }
+                        }
+                        entropy += sum;
+                }
+        }
+
+        return entropy;
 }
 
-double quality_metrics::compute_fsm_scaling_factor_unit_weight( graph_access & G ) {
-        double top_fraction    = 0;
-        double bottom_fraction = 0;
-        forall_nodes_parallel_reduce(G, source,+,top_fraction) {
-                shortest_paths sp;
-	        std::vector<int> deepth(G.number_of_nodes(), -1);
-                sp.one_to_many_unit_weight(G, source, deepth);
+double quality_metrics::maxent_entropy_sum_approximate( graph_access & G, double q, double theta, double & error_bound ) {
+        bool use_log = abs(q) < 0.001;
+        kd_tree tree;
+        tree.build(G);
 
-                forall_nodes(G, target) {
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
+        const std::vector< double > & x = tree.x();
+        const std::vector< double > & y = tree.y();
+        const std::vector< NodeID > & points = tree.points();
 
-                        int best_distance = deepth[target];
-                        if( best_distance == 0 ) continue;
-                        top_fraction += (dist / best_distance);
+        double entropy = 0;
+        error_bound    = 0;
+        NodeID num_nodes = G.number_of_nodes();
+        #pragma omp parallel 
+        {
+                std::vector< int > stack;
+
+                #pragma omp for schedule(dynamic, 256) reduction(+:entropy,error_bound)
+                for( NodeID source = 0; source < num_nodes; source++) {
+                        stack.clear();
+                        stack.push_back(tree.root());
+                        while( !stack.empty() ) {
+                                const kd_tree_node & cell = tree.node(stack.back());
+                                stack.pop_back();
+
+                                double diffX       = x[source] - cell.center_x;
+                                double diffY       = y[source] - cell.center_y;
+                                double dist_square = diffX*diffX+diffY*diffY;
+
+                                if( cell.radius * cell.radius < theta * theta * dist_square && cell.radius * cell.radius < dist_square ) {
+                                        // summing the Taylor expansion around the centroid, the linear terms cancel. the 
+                                        // remainder of a point at offset delta is at most |delta|^2/2 times the largest 
+                                        // second derivative within radius of the centroid (at distance dist - radius).
+                                        double dist     = sqrt(dist_square);
+                                        double nearest  = dist - cell.radius;
+                                        double farthest = dist + cell.radius;
+                                        double curvature;
+                                        if( use_log ) {
+                                                curvature = 1.0 / (nearest * nearest);
+                                        } else {
+                                                curvature = fabs(q) * std::max(fabs(q + 1), 1.0) 
+                                                            * std::max(pow(nearest, -q - 2), pow(farthest, -q - 2));
+                                        }
+
+                                        entropy     += (cell.end - cell.begin) * entropy_term(dist_square, q, use_log);
+                                        error_bound += 0.5 * cell.second_moment * curvature;
+                                } else if( cell.left == -1 ) {
+                                        for( NodeID i = cell.begin; i < cell.end; i++) {
+                                                NodeID target = points[i];
+                                                if( target == source ) continue;
+
+                                                double targetX = x[source] - x[target];
+                                                double targetY = y[source] - y[target];
+                                                entropy += entropy_term(targetX*targetX+targetY*targetY, q, use_log);
+                                        }
+                                } else {
+                                        stack.push_back(cell.left);
+                                        stack.push_back(cell.right);
+                                }
+                        }
+                }
+        }
 
-                } endfor
+        return entropy;
+}
+
+// accumulates the full stress sums of the pairs reported by a multi-source BFS
+struct full_stress_visitor {
+        full_stress_visitor( const std::vector< double > & x, const std::vector< double > & y ) 
+                : x(x), y(y), deepth(1), inverse_distance(1), top_fraction(0), bottom_fraction(0), num_pairs(0) {}
+
+        void init( const NodeID * sources, unsigned num_sources ) {
+                for( unsigned i = 0; i < num_sources; i++) {
+                        source_x[i] = x[sources[i]];
+                        source_y[i] = y[sources[i]];
+                }
+        }
+
+        inline void operator()( unsigned i, NodeID target, int best_distance ) {
+                if( best_distance <= 0 ) return;
+
+                double diffX       = source_x[i] - x[target];
+                double diffY       = source_y[i] - y[target];
+                double dist_square = diffX*diffX+diffY*diffY;
+
+                // the BFS reports the nodes level by level, so the division is rarely needed
+                if( best_distance != deepth ) {
+                        deepth           = best_distance;
+                        inverse_distance = 1.0 / best_distance;
+                }
+                top_fraction    += sqrt(dist_square) * inverse_distance;
+                bottom_fraction += dist_square * inverse_distance * inverse_distance;
+                num_pairs       += 1;
+        }
+
+        const std::vector< double > & x;
+        const std::vector< double > & y;
+        int    deepth;
+        double inverse_distance;
+        double source_x[MSBFS_BATCH_SIZE];
+        double source_y[MSBFS_BATCH_SIZE];
+        double top_fraction;
+        double bottom_fraction;
+        double num_pairs;
+};
+
+// same as above, but the sums are kept separately for each source of the batch
+struct source_stress_visitor {
+        source_stress_visitor( const std::vector< double > & x, const std::vector< double > & y ) 
+                : x(x), y(y), deepth(1), inverse_distance(1) {}
+
+        void init( const NodeID * sources, unsigned num_sources ) {
+                for( unsigned i = 0; i < num_sources; i++) {
+                        source_x[i]        = x[sources[i]];
+                        source_y[i]        = y[sources[i]];
+                        top_fraction[i]    = 0;
+                        bottom_fraction[i] = 0;
+                        num_pairs[i]       = 0;
+                }
+        }
+
+        inline void operator()( unsigned i, NodeID target, int best_distance ) {
+                if( best_distance <= 0 ) return;
+
+                double diffX       = source_x[i] - x[target];
+                double diffY       = source_y[i] - y[target];
+                double dist_square = diffX*diffX+diffY*diffY;
+
+                if( best_distance != deepth ) {
+                        deepth           = best_distance;
+                        inverse_distance = 1.0 / best_distance;
+                }
+                top_fraction[i]    += sqrt(dist_square) * inverse_distance;
+                bottom_fraction[i] += dist_square * inverse_distance * inverse_distance;
+                num_pairs[i]       += 1;
+        }
+
+        const std::vector< double > & x;
+        const std::vector< double > & y;
+        int    deepth;
+        double inverse_distance;
+        double source_x[MSBFS_BATCH_SIZE];
+        double source_y[MSBFS_BATCH_SIZE];
+        double top_fraction[MSBFS_BATCH_SIZE];
+        double bottom_fraction[MSBFS_BATCH_SIZE];
+        double num_pairs[MSBFS_BATCH_SIZE];
+};
+
+// running means of the per source values of top, bottom and pairs and their centered co-moments 
+// (Welford), enough for the variance of any linear combination of them. raw sums of products 
+// would cancel badly when the variance is small against the means
+struct stress_moments {
+        stress_moments() : num_sources(0), top(0), bottom(0), pairs(0), top_top(0), bottom_bottom(0), 
+                           pairs_pairs(0), top_bottom(0), top_pairs(0), bottom_pairs(0) {}
+
+        void add( double t, double b, double p ) {
+                num_sources++;
+                double N        = num_sources;
+                double delta_t  = t - top;
+                double delta_b  = b - bottom;
+                double delta_p  = p - pairs;
+                top            += delta_t / N;
+                bottom         += delta_b / N;
+                pairs          += delta_p / N;
+                top_top        += delta_t * (t - top);
+                bottom_bottom  += delta_b * (b - bottom);
+                pairs_pairs    += delta_p * (p - pairs);
+                top_bottom     += delta_t * (b - bottom);
+                top_pairs      += delta_t * (p - pairs);
+                bottom_pairs   += delta_b * (p - pairs);
+        }
+
+        // sample variance of c_t * top + c_b * bottom + c_p * pairs
+        double variance( double c_t, double c_b, double c_p ) {
+                if( num_sources < 2 ) return 0;
+                double sum = c_t*c_t*top_top + c_b*c_b*bottom_bottom + c_p*c_p*pairs_pairs 
+                           + 2*c_t*c_b*top_bottom + 2*c_t*c_p*top_pairs + 2*c_b*c_p*bottom_pairs;
+                return std::max(0.0, sum) / (num_sources - 1);
+        }
+
+        NodeID num_sources;
+        double top, bottom, pairs;                       // means
+        double top_top, bottom_bottom, pairs_pairs;      // sums of squared deviations from the mean
+        double top_bottom, top_pairs, bottom_pairs;      // sums of products of deviations
+};
+
+int quality_metrics::bfs_threads() {
+        if( m_num_threads > 0 ) return std::min(m_num_threads, omp_get_max_threads());
+        return omp_get_max_threads();
+}
+
+static void copy_coordinates( graph_access & G, std::vector< double > & x, std::vector< double > & y ) {
+        x.resize(G.number_of_nodes());
+        y.resize(G.number_of_nodes());
+        forall_nodes(G, node) {
+                x[node] = G.getX(node);
+                y[node] = G.getY(node);
         } endfor
+}
 
-        forall_nodes_parallel_reduce(G, source,+,bottom_fraction) {
+void quality_metrics::full_stress_sums_unit_weight( graph_access & G, double & top_fraction, double & bottom_fraction, double & num_pairs ) {
+        top_fraction    = 0;
+        bottom_fraction = 0;
+        num_pairs       = 0;
+
+        std::vector< double > x, y;
+        copy_coordinates(G, x, y);
+
+        // sources are processed in batches of nodes that are consecutive in BFS order, 
+        // the bitsets are reused by each thread
+        shortest_paths order_sp;
+        std::vector< NodeID > sources;
+        order_sp.bfs_order(G, sources);
+        long num_batches = (G.number_of_nodes() + MSBFS_BATCH_SIZE - 1) / MSBFS_BATCH_SIZE;
+        int  num_threads = bfs_threads();
+        #pragma omp parallel num_threads(num_threads) reduction(+:top_fraction,bottom_fraction,num_pairs)
+        {
                 shortest_paths sp;
-	        std::vector<int> deepth(G.number_of_nodes(), -1);
-                sp.one_to_many_unit_weight(G, source, deepth);
+                msbfs_buffers buffers;
+                full_stress_visitor visitor(x, y);
+
+                #pragma omp for schedule(dynamic, 1)
+                for( long batch = 0; batch < num_batches; batch++) {
+                        NodeID first_source  = batch * MSBFS_BATCH_SIZE;
+                        unsigned num_sources = std::min((NodeID)MSBFS_BATCH_SIZE, G.number_of_nodes() - first_source);
+
+                        visitor.init(&sources[first_source], num_sources);
+                        sp.multi_source_unit_weight(G, &sources[first_source], num_sources, buffers, visitor);
+                }
+                top_fraction    += visitor.top_fraction;
+                bottom_fraction += visitor.bottom_fraction;
+                num_pairs       += visitor.num_pairs;
+        }
+}
 
-                forall_nodes(G, target) {
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
+stress_estimate quality_metrics::sampled_stress_measure_unit_weight( graph_access & G, double target_error, NodeID min_sources ) {
+        NodeID n = G.number_of_nodes();
+        stress_estimate estimate;
+        estimate.stress         = 0;
+        estimate.confidence     = 0;
+        estimate.scaling_factor = 1;
+        estimate.num_sources    = 0;
+        if( n == 0 ) return estimate;
+
+        std::vector< double > x, y;
+        copy_coordinates(G, x, y);
+
+        // the sources are a prefix of a random permutation, i.e. a sample without replacement
+        std::vector< NodeID > sources(n);
+        random_functions::permutate_vector_good(sources, true);
+
+        // the values of the sources are only kept for one round and then added to the 
+        // moments in the order of the sources, so memory does not grow with the sample
+        int num_threads   = bfs_threads();
+        NodeID round_size = MSBFS_BATCH_SIZE * std::max(1, num_threads);
+        std::vector< double > round_top(round_size, 0);
+        std::vector< double > round_bottom(round_size, 0);
+        std::vector< double > round_pairs(round_size, 0);
+        stress_moments moments;
+
+        NodeID sampled    = 0;
+        while( sampled < n ) {
+                NodeID round_end   = std::min(n, sampled + round_size);
+                long   num_batches = (round_end - sampled + MSBFS_BATCH_SIZE - 1) / MSBFS_BATCH_SIZE;
+                #pragma omp parallel num_threads(num_threads)
+                {
+                        shortest_paths sp;
+                        msbfs_buffers buffers;
+                        source_stress_visitor visitor(x, y);
+
+                        #pragma omp for schedule(dynamic, 1)
+                        for( long batch = 0; batch < num_batches; batch++) {
+                                NodeID first_source  = sampled + batch * MSBFS_BATCH_SIZE;
+                                unsigned num_sources = std::min((NodeID)MSBFS_BATCH_SIZE, round_end - first_source);
+
+                                visitor.init(&sources[first_source], num_sources);
+                                sp.multi_source_unit_weight(G, &sources[first_source], num_sources, buffers, visitor);
+
+                                for( unsigned i = 0; i < num_sources; i++) {
+                                        round_top[first_source - sampled + i]    = visitor.top_fraction[i];
+                                        round_bottom[first_source - sampled + i] = visitor.bottom_fraction[i];
+                                        round_pairs[first_source - sampled + i]  = visitor.num_pairs[i];
+                                }
+                        }
+                }
+                for( NodeID i = 0; i < round_end - sampled; i++) {
+                        moments.add(round_top[i], round_bottom[i], round_pairs[i]);
+                }
+                sampled = round_end;
+
+                double mean_top    = moments.top;
+                double mean_bottom = moments.bottom;
+                double mean_pairs  = moments.pairs;
+                if( mean_bottom <= 0 ) continue;
+
+                // the sums over all pairs are estimated by n times the sample means. stress is a
+                // nonlinear function of them, its variance is approximated by the variance of the
+                // linearized contributions 0.5 pairs - s top + 0.5 s^2 bottom of the sources (delta method)
+                double scaling_factor    = mean_top / mean_bottom;
+                double mean_contribution = 0.5 * (mean_pairs - scaling_factor * mean_top);
+                double variance          = moments.variance(-scaling_factor, 0.5 * scaling_factor * scaling_factor, 0.5);
+                double finite_population = 1.0 - (double)sampled / n;
+
+                estimate.stress         = n * mean_contribution;
+                estimate.confidence     = 1.96 * n * sqrt(variance * finite_population / sampled);
+                estimate.scaling_factor = scaling_factor;
+                estimate.num_sources    = sampled;
+
+                if( sampled >= min_sources && estimate.confidence <= target_error * estimate.stress ) break;
+        }
 
-                        int best_distance = deepth[target];
-                        if( best_distance == 0 ) continue;
-                        bottom_fraction += (dist*dist) / (best_distance*best_distance);
+        return estimate;
+}
 
-                } endfor
-        } endfor
+double quality_metrics::full_stress_measure_unit_weight( graph_access & G ) {
+        // sum (s*d - D)^2/D^2 = s^2 * bottom - 2s * top + pairs, which is
+        // pairs - top^2/bottom for the optimal scaling factor s = top/bottom
+        double top_fraction, bottom_fraction, num_pairs;
+        full_stress_sums_unit_weight(G, top_fraction, bottom_fraction, num_pairs);
+
+        double scaling_factor = top_fraction/bottom_fraction;
+        std::cout <<  "scaling factor is " << scaling_factor  << std::endl;
+
+        double energy = num_pairs - top_fraction*top_fraction/bottom_fraction;
+        return energy/2;
+}
 
+double quality_metrics::compute_fsm_scaling_factor_unit_weight( graph_access & G ) {
+        double top_fraction, bottom_fraction, num_pairs;
+        full_stress_sums_unit_weight(G, top_fraction, bottom_fraction, num_pairs);
 
         return top_fraction/bottom_fraction;
 }
@@ -264,21 +594,71 @@ double quality_metrics::compute_sparse_scaling_factor_unit_weight( graph_access
 }
 
 
-double quality_metrics::avg_infeasibility_per_edge( graph_access & G) {
-        double total_infisibility = 0;
+double quality_metrics::neighborhood_preservation( graph_access & G ) {
+        kd_tree tree;
+        tree.build(G);
+
+        // the queries are issued in the leaf order of the tree, so consecutive queries of a thread 
+        // visit the same part of the tree
+        const std::vector< NodeID > & points = tree.points();
+        long num_points   = points.size();
+        double similarity = 0;
+        double num_nodes  = 0;
+
+        #pragma omp parallel
+        {
+                std::vector< std::pair< double, NodeID > > nearest;
+                std::vector< NodeID > graph_neighbors;
+                std::vector< NodeID > layout_neighbors;
+
+                #pragma omp for schedule(dynamic, 256) reduction(+:similarity,num_nodes)
+                for( long i = 0; i < num_points; i++) {
+                        NodeID node = points[i];
+                        unsigned k  = G.getNodeDegree(node);
+                        if( k == 0 ) continue;
+
+                        tree.k_nearest(node, k, nearest);
+                        layout_neighbors.clear();
+                        for( unsigned j = 0; j < nearest.size(); j++) {
+                                layout_neighbors.push_back(nearest[j].second);
+                        }
 
-        forall_nodes(G, source) {
-                forall_out_edges(G, e, source) {
-                        NodeID target = G.getEdgeTarget(e);
+                        graph_neighbors.clear();
+                        forall_out_edges(G, e, node) {
+                                graph_neighbors.push_back(G.getEdgeTarget(e));
+                        } endfor
+
+                        std::sort(layout_neighbors.begin(), layout_neighbors.end());
+                        std::sort(graph_neighbors.begin(), graph_neighbors.end());
+                        std::vector< NodeID >::iterator lhs = layout_neighbors.begin();
+                        std::vector< NodeID >::iterator rhs = graph_neighbors.begin();
+                        unsigned common = 0;
+                        while( lhs != layout_neighbors.end() && rhs != graph_neighbors.end() ) {
+                                if( *lhs < *rhs ) {
+                                        lhs++;
+                                } else if( *rhs < *lhs ) {
+                                        rhs++;
+                                } else {
+                                        common++; lhs++; rhs++;
+                                }
+                        }
 
-                        double diffX       = G.getX(source) - G.getX(target);
-                        double diffY       = G.getY(source) - G.getY(target);
-                        double dist_square = diffX*diffX+diffY*diffY;
-                        double dist        = sqrt(dist_square);
+                        similarity += common / (double)(layout_neighbors.size() + graph_neighbors.size() - common);
+                        num_nodes  += 1;
+                }
+        }
 
-                        total_infisibility += fabs(1.0-dist);
-                } endfor
-        } endfor
+        return num_nodes > 0 ? similarity / num_nodes : 1;
+}
+
+void quality_metrics::edge_crossings( graph_access & G, EdgeID sample_size, crossing_stats & stats ) {
+        crossing_counter counter;
+        counter.count_crossings(G, sample_size, stats);
+}
+
+double quality_metrics::avg_infeasibility_per_edge( graph_access & G) {
+        edge_length_sums edge_sums;
+        edge_sums_unit_weight(G, 0, edge_sums);
         
-        return total_infisibility/(double)G.number_of_edges();
+        return edge_sums.infeasibility/(double)G.number_of_edges();
 }
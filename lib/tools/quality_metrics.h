@@ -23,8 +23,22 @@
 #ifndef QUALITY_METRICS_4AJHZVX0
 #define QUALITY_METRICS_4AJHZVX0
 
+#include "crossing_counter.h"
 #include "data_structure/graph_access.h"
 
+struct stress_estimate {
+        double stress;         // estimated full stress measure
+        double confidence;     // half width of the 95% confidence interval of stress
+        double scaling_factor; // estimated optimal scaling factor
+        NodeID num_sources;    // number of BFS sources the estimate is based on
+};
+
+struct edge_length_sums {
+        double energy;        // sum of (dist - 1)^2
+        double entropy;       // sum of log(dist), or dist^-q if q != 0
+        double infeasibility; // sum of |1 - dist|
+};
+
 class quality_metrics {
 public:
         quality_metrics();
@@ -35,9 +49,47 @@ public:
         double full_stress_measure_unit_weight( graph_access & G );
         double maxent_unitweight( graph_access & G, double q, double alpha, std::string prefix );
         double maxent_unitweight( graph_access & G, double q, double alpha );
+
+        // maxent_unitweight for large graphs: the entropy term is approximated by a Barnes-Hut traversal
+        // of a kd-tree, a cell is summarized by its centroid if its radius is below theta times the distance.
+        // error_bound receives a bound on the absolute error of the returned energy.
+        double maxent_unitweight_approximate( graph_access & G, double q, double alpha, double theta, double & error_bound );
         double avg_infeasibility_per_edge( graph_access & G );
         double compute_fsm_scaling_factor_unit_weight( graph_access & G ); 
         double compute_sparse_scaling_factor_unit_weight( graph_access & G ); 
+
+        // one BFS per source: top = sum d/D, bottom = sum d^2/D^2 and the number of pairs with D != 0,
+        // where d is the euclidean and D the graph theoretic distance
+        void full_stress_sums_unit_weight( graph_access & G, double & top_fraction, double & bottom_fraction, double & num_pairs );
+
+        // estimates the full stress measure and its scaling factor from BFS runs of random sources.
+        // sources are added in rounds until the confidence interval is within target_error times 
+        // the estimate (relative) and at least min_sources are used. if all nodes end up being
+        // sources the result is exact.
+        stress_estimate sampled_stress_measure_unit_weight( graph_access & G, double target_error, NodeID min_sources = 256 );
+
+        // average over all nodes with neighbors of the Jaccard similarity of the graph neighbors of a node 
+        // and its deg(node) nearest neighbors in the drawing (1 means every neighborhood is preserved)
+        double neighborhood_preservation( graph_access & G );
+
+        // number of edge crossings, sampled from sample_size random edges unless sample_size is 0
+        void edge_crossings( graph_access & G, EdgeID sample_size, crossing_stats & stats );
+
+        // one parallel pass over the edges (both directions), see edge_length_sums
+        void edge_sums_unit_weight( graph_access & G, double q, edge_length_sums & sums );
+
+        // sum of log(dist) or dist^-q over all ordered pairs of distinct nodes, exact or with a kd-tree
+        double maxent_entropy_sum( graph_access & G, double q );
+        double maxent_entropy_sum_approximate( graph_access & G, double q, double theta, double & error_bound );
+
+        // threads of the BFS based measures (0 means all), every thread needs 
+        // MSBFS_BYTES_PER_NODE bytes per node for its buffers
+        void set_num_threads( int num_threads ) { m_num_threads = num_threads; }
+
+private:
+        int bfs_threads();
+
+        int m_num_threads;
 };
 
 
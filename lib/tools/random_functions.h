@@ -158,7 +158,8 @@ class random_functions {
                 }
 
                 static double nextDouble(double lb, double rb) {
-                        double rnbr   = (double) rand() / (double) RAND_MAX; // rnd in 0,1
+                        std::uniform_real_distribution<double> A(0,1);
+                        double rnbr   = A(m_mt); // rnd in 0,1
                         double length = rb - lb;
                         rnbr         *= length;
                         rnbr         += lb;
@@ -173,8 +174,12 @@ class random_functions {
                 }
 
         private:
-                static int m_seed;
-                static MersenneTwister m_mt;
+                // every thread has its own generator, so that independent drawings can run 
+                // concurrently and are reproducible. setSeed only seeds the calling thread, 
+                // OpenMP worker threads start from the default state unless they call setSeed 
+                // themselves (as component_drawer does for every component).
+                static thread_local int m_seed;
+                static thread_local MersenneTwister m_mt;
 };
 
 #endif /* end of include guard: RANDOM_FUNCTIONS_RMEPKWYT */
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * trace_recorder.cpp 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdio.h>
+
+#include "trace_recorder.h"
+
+bool trace_recorder::m_enabled = false;
+thread_local bool trace_recorder::m_counting = false;
+std::chrono::steady_clock::time_point trace_recorder::m_start;
+std::mutex trace_recorder::m_mutex;
+std::deque< trace_recorder::thread_buffer > trace_recorder::m_buffers;
+
+void trace_recorder::enable() {
+        m_start   = std::chrono::steady_clock::now();
+        m_enabled = true;
+}
+
+bool trace_recorder::enable_counters() {
+        m_counting = perf_counters::open();
+        return m_counting;
+}
+
+void trace_recorder::record( const char * name, long arg, double begin, const perf_sample * begin_counters ) {
+        trace_event event;
+        event.has_counters = begin_counters != NULL;
+        if( event.has_counters ) {
+                perf_sample end_counters;
+                perf_counters::read(end_counters);
+                for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                        bool valid = begin_counters->value[counter] >= 0 && end_counters.value[counter] >= 0;
+                        event.counters[counter] = valid ? end_counters.value[counter] - begin_counters->value[counter] : -1;
+                }
+        }
+        event.name     = name;
+        event.arg      = arg;
+        event.begin    = begin;
+        event.duration = now() - begin;
+        local_buffer().events.push_back(event);
+}
+
+trace_recorder::thread_buffer & trace_recorder::local_buffer() {
+        // elements of a deque stay in place when it grows
+        static thread_local thread_buffer * buffer = NULL;
+        if( buffer == NULL ) {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_buffers.push_back(thread_buffer());
+                buffer      = &m_buffers.back();
+                buffer->tid = m_buffers.size() - 1;
+        }
+        return *buffer;
+}
+
+bool trace_recorder::write( const std::string & filename ) {
+        FILE * out = fopen(filename.c_str(), "w");
+        if( out == NULL ) {
+                std::cerr << "Error opening " << filename << std::endl;
+                return false;
+        }
+
+        std::lock_guard< std::mutex > lock(m_mutex);
+        fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        bool first = true;
+        for( unsigned i = 0; i < m_buffers.size(); i++) {
+                thread_buffer & buffer = m_buffers[i];
+                fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                        first ? "" : ",\n", buffer.tid, buffer.tid);
+                first = false;
+
+                for( unsigned j = 0; j < buffer.events.size(); j++) {
+                        trace_event & event = buffer.events[j];
+                        fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                                event.name, buffer.tid, event.begin, event.duration);
+                        bool first_arg = true;
+                        if( event.arg >= 0 ) {
+                                fprintf(out, ",\"args\":{\"value\":%ld", event.arg);
+                                first_arg = false;
+                        }
+                        for( int counter = 0; event.has_counters && counter < NUM_PERF_COUNTERS; counter++) {
+                                if( event.counters[counter] < 0 ) continue;
+                                fprintf(out, "%s\"%s\":%lld", first_arg ? ",\"args\":{" : ",", 
+                                        perf_counters::counter_name(counter), event.counters[counter]);
+                                first_arg = false;
+                        }
+                        fprintf(out, first_arg ? "}" : "}}");
+                }
+        }
+        fprintf(out, "\n]}\n");
+        fclose(out);
+        return true;
+}
+
+void trace_recorder::print_summary() {
+        struct summary_row {
+                const char * name;
+                long arg;
+                double first_begin;
+                long calls;
+                double duration;
+                bool has_counters;
+                long long counters[NUM_PERF_COUNTERS];
+        };
+
+        std::lock_guard< std::mutex > lock(m_mutex);
+        std::vector< summary_row > rows;
+        std::map< std::pair< std::string, long >, unsigned > row_of;
+        for( unsigned i = 0; i < m_buffers.size(); i++) {
+                for( unsigned j = 0; j < m_buffers[i].events.size(); j++) {
+                        trace_event & event = m_buffers[i].events[j];
+                        std::pair< std::string, long > key(event.name, event.arg);
+                        if( row_of.find(key) == row_of.end() ) {
+                                summary_row row;
+                                row.name         = event.name;
+                                row.arg          = event.arg;
+                                row.first_begin  = event.begin;
+                                row.calls        = 0;
+                                row.duration     = 0;
+                                row.has_counters = false;
+                                for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                                        row.counters[counter] = 0;
+                                }
+                                row_of[key] = rows.size();
+                                rows.push_back(row);
+                        }
+
+                        summary_row & row = rows[row_of[key]];
+                        row.first_begin = std::min(row.first_begin, event.begin);
+                        row.calls++;
+                        row.duration += event.duration;
+                        if( !event.has_counters ) continue;
+
+                        row.has_counters = true;
+                        for( int counter = 0; counter < NUM_PERF_COUNTERS; counter++) {
+                                if( event.counters[counter] < 0 || row.counters[counter] < 0 ) {
+                                        row.counters[counter] = -1;
+                                } else {
+                                        row.counters[counter] += event.counters[counter];
+                                }
+                        }
+                }
+        }
+        std::sort( rows.begin(), rows.end(), []( const summary_row & lhs, const summary_row & rhs ) { 
+                        return lhs.first_begin < rhs.first_begin; } );
+
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision     = std::cout.precision();
+        std::cout <<  "phase summary (time summed over all calls and threads";
+        if( m_counting ) {
+                std::cout <<  ", counters of the whole process for the scopes of the main thread";
+        } else if( perf_counters::error() != "not opened" ) {
+                std::cout <<  ", hardware counters unavailable: " << perf_counters::error();
+        }
+        std::cout <<  ")" << std::endl;
+        std::cout <<  std::left << std::setw(36) << "phase" << std::right << std::setw(8) << "calls" << std::setw(12) << "time [s]";
+        if( m_counting ) {
+                std::cout <<  std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(7) << "IPC"
+                          <<  std::setw(14) << "LLC misses" << std::setw(10) << "LLC MPKI" << std::setw(15) << "branch misses";
+        }
+        std::cout <<  std::endl;
+
+        for( unsigned i = 0; i < rows.size(); i++) {
+                summary_row & row = rows[i];
+                std::string name = row.name;
+                if( row.arg >= 0 ) {
+                        std::ostringstream arg;
+                        arg << row.arg;
+                        name += " [" + arg.str() + "]";
+                }
+                std::cout <<  std::left << std::setw(36) << name << std::right << std::setw(8) << row.calls 
+                          <<  std::setw(12) << std::fixed << std::setprecision(4) << row.duration / 1e6;
+                if( m_counting && row.has_counters ) {
+                        long long * c = row.counters;
+                        double instructions = c[PERF_INSTRUCTIONS];
+                        for( int counter = 0; counter < 2; counter++) {
+                                if( c[counter] < 0 ) std::cout << std::setw(16) << "n/a"; 
+                                else std::cout << std::setw(16) << c[counter];
+                        }
+                        if( c[PERF_CYCLES] > 0 && instructions >= 0 ) std::cout << std::setw(7) << std::setprecision(2) << instructions / c[PERF_CYCLES];
+                        else std::cout << std::setw(7) << "n/a";
+                        if( c[PERF_LLC_MISSES] < 0 ) std::cout << std::setw(14) << "n/a" << std::setw(10) << "n/a";
+                        else {
+                                std::cout << std::setw(14) << c[PERF_LLC_MISSES];
+                                if( instructions > 0 ) std::cout << std::setw(10) << std::setprecision(2) << 1000.0 * c[PERF_LLC_MISSES] / instructions;
+                                else std::cout << std::setw(10) << "n/a";
+                        }
+                        if( c[PERF_BRANCH_MISSES] < 0 ) std::cout << std::setw(15) << "n/a";
+                        else std::cout << std::setw(15) << c[PERF_BRANCH_MISSES];
+                }
+                std::cout <<  std::endl;
+        }
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+}
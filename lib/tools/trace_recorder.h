@@ -0,0 +1,111 @@
+/******************************************************************************
+ * trace_recorder.h 
+ *
+ * Source of KaDraw -- Karlsruhe Graph Drawing 
+ ******************************************************************************
+ * Copyright (C) 2015 Christian Schulz <christian.schulz@kit.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef TRACE_RECORDER_Z6HN3QWE
+#define TRACE_RECORDER_Z6HN3QWE
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+
+struct trace_event {
+        const char * name;
+        long arg;         // shown as argument of the event if >= 0, e.g. the level
+        double begin;     // microseconds since the recorder was enabled
+        double duration;  // microseconds
+        bool has_counters;
+        long long counters[NUM_PERF_COUNTERS]; // hardware events during the scope, -1 if not available
+};
+
+// Collects timed scopes of all threads and writes them in the Chrome trace event format
+// (load the file in chrome://tracing or ui.perfetto.dev). Every thread records into a buffer
+// of its own, so recording needs no locks. As long as the recorder is not enabled, a scope 
+// costs a single branch.
+// With hardware counters, the scopes of the thread that enabled them additionally record the 
+// counter differences. The counters sum over all threads of the process, so scopes of other 
+// threads do not record them.
+class trace_recorder {
+public:
+        static void enable();
+        static bool enabled() { return m_enabled; }
+
+        // returns false if no hardware counter is available, only timings are recorded then
+        static bool enable_counters();
+        static bool counting() { return m_counting; }
+
+        // microseconds since enable()
+        static double now() {
+                return std::chrono::duration< double, std::micro >(std::chrono::steady_clock::now() - m_start).count();
+        }
+
+        // begin_counters is NULL if no counters were read at the begin of the scope
+        static void record( const char * name, long arg, double begin, const perf_sample * begin_counters );
+
+        // call after all parallel work is done
+        static bool write( const std::string & filename );
+
+        // prints calls, time and counters summed per scope name and argument
+        static void print_summary();
+
+private:
+        struct thread_buffer {
+                int tid;
+                std::vector< trace_event > events;
+        };
+        static thread_buffer & local_buffer();
+
+        static bool m_enabled;
+        static thread_local bool m_counting;
+        static std::chrono::steady_clock::time_point m_start;
+        static std::mutex m_mutex;
+        static std::deque< thread_buffer > m_buffers;
+};
+
+// records the time from construction to destruction as one event, names have to be literals
+class trace_scope {
+public:
+        trace_scope( const char * name, long arg = -1 ) : m_name(name), m_arg(arg), m_begin(-1), m_counting(false) {
+                if( trace_recorder::enabled() ) {
+                        m_counting = trace_recorder::counting();
+                        if( m_counting ) perf_counters::read(m_begin_counters);
+                        m_begin = trace_recorder::now();
+                }
+        }
+
+        ~trace_scope() {
+                if( m_begin >= 0 ) trace_recorder::record(m_name, m_arg, m_begin, m_counting ? &m_begin_counters : NULL);
+        }
+
+private:
+        const char * m_name;
+        long m_arg;
+        double m_begin;
+        bool m_counting;
+        perf_sample m_begin_counters;
+};
+
+
+#endif /* end of include guard: TRACE_RECORDER_Z6HN3QWE */